@@ -0,0 +1,32 @@
+/**
+ * @file AllocCounter.h
+ * @brief Заголовочный файл, содержащий отладочный счетчик выделений памяти
+ */
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <cstdint>
+
+/**
+ * @brief Отладочный счетчик вызовов operator new
+ * 
+ * При сборке с опцией TETRIS_COUNT_ALLOCATIONS глобальные operator new/delete
+ * заменяются версиями, которые считают каждое выделение памяти.
+ * Без этой опции счетчик всегда равен нулю и ничего не стоит.
+ */
+class AllocCounter {
+public:
+    /**
+     * @brief Проверяет, собран ли счетчик
+     * @return true если программа собрана с TETRIS_COUNT_ALLOCATIONS
+     */
+    static bool isEnabled();
+    
+    /**
+     * @brief Возвращает количество выделений памяти с начала работы программы
+     * @return Число вызовов operator new (0 если счетчик не собран)
+     */
+    static uint64_t getCount();
+};
+
+#endif
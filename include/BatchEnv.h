@@ -0,0 +1,191 @@
+/**
+ * @file BatchEnv.h
+ * @brief Заголовочный файл, содержащий объявление класса BatchEnv - пакета полей, которые ходят одновременно
+ */
+#ifndef BATCHENV_H
+#define BATCHENV_H
+
+#include "BoardFeatures.h"
+#include "BoardGeometry.h"
+#include "Field.h"
+#include "Randomizer.h"
+#include "TetrisEngine.h"
+#include <cstdint>
+#include <vector>
+
+static_assert(BOARD_HEIGHT < 64, "BatchEnv хранит столбец поля вместе со строками ниже дна в одном слове");
+
+/**
+ * @brief Пакет из N партий, которые делают шаг одним вызовом
+ *
+ * Для обучения с подкреплением: вместо N объектов TetrisEngine со своими
+ * полями, векторами и цветами все партии хранятся структурой массивов.
+ * Строки битбордов лежат подряд по партиям: слово строки row партии board -
+ * getRows()[row * N + board], поэтому одна строка всех полей - непрерывный
+ * массив. Фигура, счет, уровень и флаги - тоже отдельные массивы по партиям.
+ *
+ * step() принимает по действию на партию и применяет их по правилам
+ * TetrisEngine::step() (сдвиг вбок по диагонали вниз, поворот со строкой
+ * вниз, очки 40 x уровень за ускорение и 50 x уровень за строку дропа,
+ * 100/300/500/800 x уровень за линии). Проверки столкновений и заполненных
+ * строк идут сразу по четырем партиям командами AVX2, если процессор их
+ * поддерживает; иначе - переносимой версией. Сжатие строк после очистки
+ * и выдача следующей фигуры выполняются для каждой партии отдельно: они
+ * нужны только на фиксации.
+ *
+ * Кроме строк, для каждой партии хранятся слова столбцов: глубина дропа
+ * считается по ним без прохода по строкам.
+ *
+ * Поддерживаются классическое поле и ведро. Режимы картинки хранят
+ * состояние картинки вне битборда, для них используется классическое поле.
+ * Партия с номером i после reset(seed) играет ту же последовательность
+ * фигур, что TetrisEngine с зерном seed + i.
+ */
+class BatchEnv {
+private:
+    int count;                          /**< Количество партий */
+    GameMode mode;                      /**< Режим (classic или bucket) */
+    RandomizerKind randomizerKind;      /**< Алгоритм выдачи фигур */
+    bool simd;                          /**< Используются ядра AVX2 */
+    BoardRow wallRows[BOARD_HEIGHT];    /**< Стенки и дно (одинаковы для всех партий) */
+    BoardRow wallColumns[BOARD_WIDTH];  /**< Стенки и дно по столбцам */
+    FeatureShape featureShape;          /**< Форма поля для extractFeatures */
+    std::vector<BoardRow> rows;         /**< Строки битбордов: rows[row * count + board] */
+    std::vector<BoardRow> columns;      /**< Столбцы: бит row слова columns[col * count + board]; строки ниже поля заняты */
+
+    std::vector<uint8_t> pieceType;     /**< Тип текущей фигуры */
+    std::vector<uint8_t> rotation;      /**< Состояние поворота */
+    std::vector<int16_t> pieceX;        /**< X левого верхнего угла рамки фигуры */
+    std::vector<int16_t> pieceY;        /**< Y левого верхнего угла рамки фигуры */
+    std::vector<int64_t> score;         /**< Счет */
+    std::vector<int32_t> level;         /**< Уровень */
+    std::vector<int32_t> lines;         /**< Всего очищено линий */
+    std::vector<int32_t> piecesLocked;  /**< Зафиксировано фигур */
+    std::vector<uint8_t> gameOver;      /**< Партия окончена */
+    std::vector<Randomizer> randomizers; /**< Генераторы фигур */
+
+    std::vector<int32_t> reward;        /**< Изменение счета за последний шаг (за один шаг - не больше 800 * уровень + дроп) */
+    std::vector<uint8_t> linesCleared;  /**< Очищено линий за последний шаг */
+    std::vector<uint8_t> locked;        /**< Фигура зафиксирована за последний шаг */
+    std::vector<BoardFeatures> features; /**< Признаки полей (computeFeatures) */
+
+    std::vector<uint8_t> candidateRotation; /**< Проверяемое положение: поворот */
+    std::vector<int16_t> candidateX;        /**< Проверяемое положение: X */
+    std::vector<int16_t> candidateY;        /**< Проверяемое положение: Y */
+    std::vector<uint8_t> active;            /**< Партии, для которых нужна проверка */
+    std::vector<uint8_t> blocked;           /**< Результат проверки: положение занято */
+    std::vector<uint8_t> fullRows;          /**< Заполненные строки фигуры (биты 0-3) */
+    std::vector<int32_t> dropDistance;      /**< Глубина дропа текущего шага */
+
+public:
+    /**
+     * @brief Конструктор
+     * @param boardCount Количество партий (больше 0)
+     * @param gameMode MODE_CLASSIC или MODE_BUCKET
+     * @param kind Алгоритм выдачи фигур
+     * @param allowSimd false - всегда переносимые ядра (для сравнения)
+     * @note Партии начинаются с зерен 0, 1, ...; обычно сразу вызывается reset()
+     */
+    BatchEnv(int boardCount, GameMode gameMode = MODE_CLASSIC,
+             RandomizerKind kind = RANDOMIZER_RANDOM, bool allowSimd = true);
+
+    /**
+     * @brief Начинает новые партии во всех полях
+     * @param seed Зерно партии 0; партия i получает seed + i
+     */
+    void reset(uint64_t seed);
+
+    /**
+     * @brief Начинает новую партию в одном поле
+     * @param board Номер партии
+     * @param seed Зерно партии
+     */
+    void resetBoard(int board, uint64_t seed);
+
+    /**
+     * @brief Делает шаг во всех партиях
+     * @param actions Действие для каждой партии (значения EngineAction)
+     * @note Оконченные партии и неизвестные действия ничего не меняют.
+     *       Итоги шага - getRewards(), getLinesCleared(), getLocked()
+     */
+    void step(const uint8_t* actions);
+
+    int getBoardCount() const { return count; }
+    GameMode getMode() const { return mode; }
+    bool isUsingSimd() const { return simd; }
+
+    /**
+     * @brief Возвращает строки всех полей
+     * @return BOARD_HEIGHT * getBoardCount() слов; стенки и дно входят в слова
+     */
+    const BoardRow* getRows() const { return rows.data(); }
+
+    const uint8_t* getPieceTypes() const { return pieceType.data(); }
+    const uint8_t* getRotations() const { return rotation.data(); }
+    const int16_t* getPieceX() const { return pieceX.data(); }
+    const int16_t* getPieceY() const { return pieceY.data(); }
+    const int64_t* getScores() const { return score.data(); }
+    const int32_t* getLevels() const { return level.data(); }
+    const int32_t* getLines() const { return lines.data(); }
+    const int32_t* getPiecesLocked() const { return piecesLocked.data(); }
+    const uint8_t* getGameOver() const { return gameOver.data(); }
+    const int32_t* getRewards() const { return reward.data(); }
+    const uint8_t* getLinesCleared() const { return linesCleared.data(); }
+    const uint8_t* getLocked() const { return locked.data(); }
+
+    /**
+     * @brief Считает признаки всех полей
+     * @return getBoardCount() признаков: высоты, дыры, переходы, колодцы и
+     *         перепады текущих полей, linesCleared - линии последнего шага
+     * @note Один вызов extractFeatures по строкам пакета (с AVX2 - по
+     *       четыре поля за проход); текущая фигура не учитывается
+     */
+    const BoardFeatures* computeFeatures();
+
+    /**
+     * @brief Возвращает фигуру из очереди предпросмотра партии
+     * @param board Номер партии
+     * @param index 0 - следующая фигура
+     */
+    PieceType getNextPiece(int board, int index) const { return randomizers[board].peek(index); }
+
+private:
+    /**
+     * @brief Проверяет столкновения проверяемых положений активных партий
+     * @note Результат - blocked; для неактивных партий не определен
+     */
+    void testCandidates();
+
+    /**
+     * @brief Считает глубину дропа текущих фигур активных партий в dropDistance
+     */
+    void measureDrops();
+
+    /**
+     * @brief Строит слова столбцов партии по ее строкам
+     * @note После очистки линий: сдвиг строк меняет все столбцы
+     */
+    void rebuildColumns(int board);
+
+    /**
+     * @brief Фиксирует фигуры партий, отмеченных в active
+     * @note Очистка линий, очки, уровень и новая фигура, как в TetrisEngine::lockFigure
+     */
+    void lockActive();
+
+    /**
+     * @brief Удаляет заполненные строки одной партии
+     * @param board Номер партии
+     * @param lastRow Нижняя заполненная строка
+     * @return Количество удаленных строк
+     * @note Повторяет Field::compactRows, включая сужение строк ведра
+     */
+    int compactRows(int board, int lastRow);
+
+    /**
+     * @brief Ставит следующую фигуру партии в точку появления
+     */
+    void spawn(int board, PieceType type);
+};
+
+#endif
@@ -0,0 +1,154 @@
+/**
+ * @file BeamSearchBot.h
+ * @brief Заголовочный файл, содержащий объявление класса BeamSearchBot - бота с поиском по очереди предпросмотра
+ */
+#ifndef BEAMSEARCHBOT_H
+#define BEAMSEARCHBOT_H
+
+#include "Field.h"
+#include "Figure.h"
+#include "HeuristicBot.h"
+#include "MoveGenerator.h"
+#include "TetrisEngine.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Параметры поиска
+ */
+struct BeamSearchOptions {
+    int depth = 3;                                       /**< Фигур в поиске: текущая и depth - 1 из очереди предпросмотра */
+    int width = 16;                                      /**< Ширина луча: сколько полей переходит на следующий уровень */
+    int64_t budgetMicros = 0;                            /**< Время на фигуру в микросекундах (0 - без ограничения) */
+    unsigned threads = 1;                                /**< Потоков поиска (0 - по числу ядер, 1 - без пула) */
+};
+
+/**
+ * @brief Бот с лучевым поиском на несколько фигур вперед
+ *
+ * Уровень поиска - одна фигура: для каждого поля луча HeuristicBot
+ * перебирает положения и оценивает их, из всех кандидатов уровня остаются
+ * width лучших. Оценка кандидата - эвристика итогового поля плюс награда
+ * за линии, очищенные на всем пути от корня. Выбирается положение текущей
+ * фигуры, с которого начинается лучший путь.
+ *
+ * Поля луча лежат в двух заранее созданных массивах (текущий и следующий
+ * уровень) и заполняются копированием поля-родителя, поэтому узел поиска
+ * не выделяет память. Узлы уровня делятся между потоками ThreadPool
+ * непрерывными отрезками; у каждого отрезка свой HeuristicBot и свой
+ * список кандидатов. Кандидаты сливаются в порядке узлов, поэтому при
+ * budgetMicros = 0 результат не зависит от числа потоков.
+ *
+ * Если время на фигуру истекло, незаконченный уровень отбрасывается
+ * и решение принимается по последнему полному уровню.
+ * В режиме картинки поиск идет на одну фигуру: в нем нет очистки линий,
+ * а поле картинки нельзя копировать как обычное поле.
+ */
+class BeamSearchBot {
+private:
+    /**
+     * @brief Кандидат в луч следующего уровня
+     */
+    struct Candidate {
+        float value;      /**< Оценка для отбора */
+        float lineScore;  /**< Награда за линии на пути от корня */
+        int16_t parent;   /**< Узел луча, из которого получен кандидат (-1 - корень) */
+        int16_t order;    /**< Номер положения у родителя */
+        int16_t root;     /**< Номер положения текущей фигуры, с которого начат путь */
+        Figure figure;    /**< Фигура в положении фиксации */
+    };
+
+    /**
+     * @brief Узел луча
+     */
+    struct BeamNode {
+        float value;      /**< Оценка */
+        float lineScore;  /**< Награда за линии на пути от корня */
+        int16_t root;     /**< Номер положения текущей фигуры */
+    };
+
+    BeamSearchOptions options;                           /**< Параметры поиска */
+    ThreadPool* pool;                                    /**< Пул потоков (nullptr при одном потоке) */
+    std::vector<HeuristicBot> evaluators;                /**< Оценщик на каждый отрезок узлов */
+    std::vector<std::vector<Candidate>> slotCandidates;  /**< Кандидаты каждого отрезка */
+    std::vector<Candidate> candidates;                   /**< Кандидаты уровня после слияния */
+    std::vector<Field> boards[2];                        /**< Поля луча: текущий и следующий уровень */
+    std::vector<BeamNode> nodes[2];                      /**< Узлы луча */
+    std::atomic<bool> timedOut;                          /**< Время на фигуру истекло */
+    int64_t deadline;                                    /**< Момент окончания поиска (steady_clock, мкс) */
+    MoveGenerator follower;                              /**< Генератор для пути к выбранному положению */
+    std::vector<EngineAction> path;                      /**< Путь к выбранному положению */
+    Figure target;                                       /**< Выбранное положение текущей фигуры */
+    int targetPiece;                                     /**< Номер фигуры, для которой выбрано положение */
+    int lastDepth;                                       /**< Уровней, пройденных последним поиском */
+
+public:
+    /**
+     * @brief Конструктор
+     * @param searchOptions Параметры поиска
+     * @param weights Веса эвристики
+     */
+    explicit BeamSearchBot(const BeamSearchOptions& searchOptions = BeamSearchOptions(),
+                           const BotWeights& weights = BotWeights());
+    ~BeamSearchBot();
+
+    BeamSearchBot(const BeamSearchBot&) = delete;
+    BeamSearchBot& operator=(const BeamSearchBot&) = delete;
+
+    /**
+     * @brief Меняет глубину, ширину и время поиска
+     * @note Число потоков задается только конструктором. Выбранное
+     *       положение забывается - вызывается перед каждой новой партией
+     */
+    void setSearchLimits(int depth, int width, int64_t budgetMicros);
+
+    const BeamSearchOptions& getOptions() const { return options; }
+
+    /**
+     * @brief Выбирает положение текущей фигуры и строит путь к нему
+     * @param engine Партия (поле, фигура и очередь предпросмотра)
+     * @return Действия до фиксации (последнее - ACTION_HARD_DROP);
+     *         пусто, если фигуре некуда встать
+     */
+    const std::vector<EngineAction>& plan(const TetrisEngine& engine);
+
+    /**
+     * @brief Возвращает следующее действие для автоигры
+     * @note Поиск выполняется один раз на фигуру; если гравитация сдвинула
+     *       фигуру, путь к выбранному положению строится заново генератором
+     *       ходов, а поиск повторяется, только если положение стало недостижимо
+     */
+    EngineAction nextAction(const TetrisEngine& engine);
+
+    /**
+     * @brief Возвращает число уровней, пройденных последним поиском
+     */
+    int getLastDepth() const { return lastDepth; }
+
+private:
+    /**
+     * @brief Раскрывает узлы луча [first, last) одним оценщиком
+     * @param slot Номер отрезка (оценщика и списка кандидатов)
+     * @param level Уровень луча
+     * @param first Первый узел отрезка
+     * @param last Узел за последним
+     * @param piece Фигура уровня в точке появления
+     */
+    void expand(int slot, int level, int first, int last, const Figure& piece);
+
+    /**
+     * @brief Оставляет width лучших кандидатов и строит их поля
+     * @param rootField Поле партии (родитель кандидатов корня)
+     * @param level Уровень, куда записываются поля
+     */
+    void select(const Field& rootField, int level);
+
+    /**
+     * @brief Проверяет, истекло ли время на фигуру
+     */
+    bool isOverBudget();
+};
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file BoardFeatures.h
+ * @brief Заголовочный файл, содержащий признаки поля для оценки положений и ядра их подсчета по битборду
+ */
+#ifndef BOARDFEATURES_H
+#define BOARDFEATURES_H
+
+#include "BoardGeometry.h"
+#include "Field.h"
+
+/**
+ * @brief Признаки поля после фиксации фигуры
+ */
+struct BoardFeatures {
+    int aggregateHeight;                          /**< Сумма высот столбцов */
+    int holes;                                    /**< Пустые игровые клетки под поверхностью столбца */
+    int bumpiness;                                /**< Сумма перепадов высот соседних столбцов */
+    int linesCleared;                             /**< Очищено линий этой фигурой */
+    int wells;                                    /**< Сумма глубин колодцев (столбцов ниже обоих соседей) */
+    int rowTransitions;                           /**< Смены занятой и пустой клетки вдоль строк (стенки заняты) */
+    int columnTransitions;                        /**< Смены занятой и пустой клетки вдоль столбцов (над полем пусто) */
+};
+
+/**
+ * @brief Форма поля для подсчета признаков
+ * @note Зависит только от варианта поля, поэтому одна форма годится
+ *       для всех положений фигуры и для всех полей пакета
+ */
+struct FeatureShape {
+    BoardRow open[BOARD_HEIGHT];                  /**< Игровые клетки строк (без стенок, склонов и дна) */
+    BoardRow rowEdges[BOARD_HEIGHT];              /**< Бит j - пара клеток j и j + 1 строки, из которых хотя бы одна игровая */
+    BoardRow columnEdges[BOARD_HEIGHT];           /**< Столбцы, где игровая клетка строки или строки над ней */
+    BoardRow columns;                             /**< Столбцы с игровыми клетками (без стенок): по ним считаются перепады и колодцы */
+
+    /**
+     * @brief Строит форму по стенкам поля
+     * @param field Поле (клетки фигур не учитываются)
+     */
+    explicit FeatureShape(const Field& field);
+};
+
+/**
+ * @brief Считает признаки полей за один проход по строкам
+ * @param rows Строки полей: слово строки row поля board - rows[row * count + board]
+ *        (раскладка BatchEnv); для одного поля - Field::getRows()
+ * @param count Количество полей
+ * @param shape Форма полей
+ * @param out Признаки count полей (linesCleared = 0)
+ * @param allowSimd false - всегда переносимая версия (для сравнения)
+ * @note Строка обрабатывается целиком как 64-битное слово: дыры, переходы
+ *       и высоты всех столбцов считаются битовыми операциями и popcount.
+ *       Если процессор поддерживает AVX2, четыре соседних поля идут
+ *       по дорожкам одного 256-битного регистра; иначе, при наличии POPCNT,
+ *       используется версия с аппаратным popcount
+ */
+void extractFeatures(const BoardRow* rows, int count, const FeatureShape& shape,
+                     BoardFeatures* out, bool allowSimd = true);
+
+#endif
@@ -0,0 +1,40 @@
+/**
+ * @file BoardGeometry.h
+ * @brief Заголовочный файл, содержащий размеры игрового поля, задаваемые при сборке
+ * 
+ * Размеры задаются опциями CMake TETRIS_BOARD_WIDTH и TETRIS_BOARD_HEIGHT
+ * и попадают в код как constexpr, поэтому циклы по строкам и столбцам
+ * поля имеют постоянные границы. Например, поле 10x20 по стандарту
+ * собирается с -DTETRIS_BOARD_WIDTH=12 -DTETRIS_BOARD_HEIGHT=21.
+ */
+#ifndef BOARDGEOMETRY_H
+#define BOARDGEOMETRY_H
+
+#ifndef TETRIS_BOARD_WIDTH
+#define TETRIS_BOARD_WIDTH 22
+#endif
+
+#ifndef TETRIS_BOARD_HEIGHT
+#define TETRIS_BOARD_HEIGHT 22
+#endif
+
+constexpr int BOARD_WIDTH = TETRIS_BOARD_WIDTH;    /**< Ширина поля вместе с левой и правой стенками */
+constexpr int BOARD_HEIGHT = TETRIS_BOARD_HEIGHT;  /**< Высота поля вместе с дном */
+constexpr int BOARD_CELLS = BOARD_WIDTH * BOARD_HEIGHT;
+constexpr int BOARD_FLOOR_ROW = BOARD_HEIGHT - 1;  /**< Строка дна */
+constexpr int BOARD_RIGHT_WALL = BOARD_WIDTH - 1;  /**< Столбец правой стенки */
+
+constexpr int SPAWN_X = (BOARD_WIDTH - 4) / 2 + 1; /**< X появления фигуры (матрица 4x4 по центру) */
+constexpr int SPAWN_Y = 1;                         /**< Y появления фигуры */
+
+constexpr int MIN_TERMINAL_ROWS = BOARD_HEIGHT + 2;    /**< Минимальная высота терминала */
+constexpr int MIN_TERMINAL_COLS = BOARD_WIDTH * 2 + 4; /**< Минимальная ширина терминала (клетка - 2 символа) */
+constexpr int PICTURE_MESSAGE_ROW = BOARD_HEIGHT + 5;  /**< Строка сообщений режима "Собери картинку" */
+
+static_assert(BOARD_WIDTH >= 8 && BOARD_WIDTH <= 63,
+              "Ширина поля должна быть от 8 до 63: строка хранится в 64-битном слове BoardRow, "
+              "и хотя бы один бит за правой границей всегда занят");
+static_assert(BOARD_HEIGHT >= 8 && BOARD_HEIGHT <= 127,
+              "Высота поля должна быть от 8 до 127");
+
+#endif
@@ -8,6 +8,7 @@
 
 #include "Field.h"
 #include "PictureField.h"
+#include "FrameBuffer.h"
 #include <vector>
 #include <string>
 
@@ -16,6 +17,8 @@
  * 
  * Отвечает за всю графику в терминале, включая цветовое оформление,
  * отображение текущей фигуры, "призрачной" фигуры и специальных режимов.
+ * Клетки поля рисуются в FrameBuffer, а на экран выводится только
+ * разница с предыдущим кадром.
  */
 class ConsoleView {
 public:
@@ -42,7 +45,7 @@ public:
      * @param newY Новая Y-координата
      * @note Очищает старое положение и отрисовывает новое
      */
-    void ShowFigure(Figure& oldFigure, Figure& figure, Field& field, 
+    void ShowFigure(const Figure& oldFigure, const Figure& figure, Field& field, 
                     int oldX, int oldY, int newX, int newY);
     
     /**
@@ -56,7 +59,7 @@ public:
      * @param figure Фигура для отображения
      * @param field Игровое поле
      */
-    void ShowPlacedFigure(Figure& figure, Field& field);
+    void ShowPlacedFigure(const Figure& figure, Field& field);
     
     /**
      * @brief Обновляет отображение после очистки линий
@@ -71,14 +74,14 @@ public:
      * @param field Игровое поле
      * @note Показывает, куда упадет фигура при быстром падении
      */
-    void ShowGhostFigure(Figure& figure, Field& field);
+    void ShowGhostFigure(const Figure& figure, Field& field);
     
     /**
      * @brief Очищает "призрачную" фигуру
      * @param figure Фигура, для которой нужно очистить предпросмотр
      * @param field Игровое поле
      */
-    void ClearGhostFigure(Figure& figure, Field& field);
+    void ClearGhostFigure(const Figure& figure, Field& field);
     
     /**
      * @brief Отображает поле в режиме "Собери картинку"
@@ -88,6 +91,42 @@ public:
     void ShowPictureField(Field& field);
 
     void ShowPictureBackground(PictureField& pictureField);
+    
+    /**
+     * @brief Сбрасывает кадр на экране
+     * @note Следующий ShowField/ShowPictureField очистит экран и перерисует поле целиком
+     */
+    void invalidate();
+
+private:
+    /**
+     * @brief Подгоняет размер буфера кадра под поле
+     * @param field Игровое поле
+     */
+    void prepareFrame(Field& field);
+    
+    /**
+     * @brief Записывает в буфер кадра пустую клетку поля
+     * @note В режиме картинки пустая клетка целевой области рисуется контуром
+     */
+    void clearCell(Field& field, int row, int col);
+    
+    /**
+     * @brief Записывает в буфер кадра "призрачную" фигуру
+     * @param figure Текущая фигура
+     * @param field Игровое поле
+     */
+    void drawGhost(const Figure& figure, Field& field);
+    
+    /**
+     * @brief Сравнивает тип, поворот и позицию двух фигур
+     */
+    static bool isSameState(const Figure& a, const Figure& b);
+    
+    FrameBuffer frame;           /**< Двойной буфер клеток поля */
+    bool figureShown;            /**< Фигура и призрак в буфере соответствуют shownFigure */
+    Figure shownFigure;          /**< Фигура, показанная последним ShowFigure */
+    uint32_t shownFieldVersion;  /**< Версия поля при последнем ShowFigure */
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+/**
+ * @file CpuFeatures.h
+ * @brief Заголовочный файл, содержащий проверку наборов команд процессора для выбора SIMD-ядер
+ *
+ * Ядра с AVX2 и POPCNT компилируются атрибутом target в обычной сборке,
+ * без флагов -mavx2 и -mpopcnt для всего проекта, а вызываются, только если
+ * процессор их поддерживает. Так одна сборка работает на любом x86-64,
+ * а на других платформах остаются переносимые версии.
+ */
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define TETRIS_HAVE_AVX2_KERNELS 1
+#define TETRIS_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#define TETRIS_TARGET_POPCNT __attribute__((target("popcnt")))
+#else
+#define TETRIS_HAVE_AVX2_KERNELS 0
+#define TETRIS_TARGET_AVX2
+#define TETRIS_TARGET_POPCNT
+#endif
+
+/** Функция встраивается и в ядра с атрибутом target (тело компилируется с их набором команд) */
+#if defined(__GNUC__) || defined(__clang__)
+#define TETRIS_FORCE_INLINE inline __attribute__((always_inline))
+#else
+#define TETRIS_FORCE_INLINE inline
+#endif
+
+/**
+ * @brief Проверяет, поддерживает ли процессор AVX2 (ядра AVX2 используют и POPCNT)
+ * @return false, если ядра AVX2 не собраны для этой платформы
+ */
+inline bool cpuHasAvx2() {
+#if TETRIS_HAVE_AVX2_KERNELS
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Проверяет, есть ли у процессора команда POPCNT (SSE4.2)
+ * @return false, если ядра AVX2 не собраны для этой платформы
+ */
+inline bool cpuHasPopcnt() {
+#if TETRIS_HAVE_AVX2_KERNELS
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("popcnt");
+#else
+    return false;
+#endif
+}
+
+#endif
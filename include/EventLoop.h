@@ -0,0 +1,39 @@
+/**
+ * @file EventLoop.h
+ * @brief Заголовочный файл, содержащий объявление класса EventLoop - ожидания событий терминала
+ */
+#ifndef EVENTLOOP_H
+#define EVENTLOOP_H
+
+#include <cstdint>
+
+/**
+ * @brief Флаги событий, возвращаемые EventLoop::wait()
+ */
+enum EventFlags {
+    EVENT_NONE = 0,    /**< Ничего не произошло */
+    EVENT_INPUT = 1,   /**< Во входном потоке есть данные */
+    EVENT_RESIZE = 2,  /**< Изменился размер терминала (SIGWINCH) */
+    EVENT_TIMEOUT = 4  /**< Истек таймаут (наступил дедлайн) */
+};
+
+/**
+ * @brief Ожидание событий одним системным вызовом
+ * 
+ * Ждет ввод со stdin, сигнал SIGWINCH (через self-pipe TerminalHelper)
+ * и дедлайн игрового цикла в одном вызове ppoll(). Пока событий нет,
+ * процесс спит и не расходует процессорное время. Перед ожиданием
+ * накопленный вывод TerminalOutput сбрасывается на экран.
+ */
+class EventLoop {
+public:
+    /**
+     * @brief Ждет ближайшего события
+     * @param timeoutMicros Таймаут в микросекундах (отрицательный - ждать бесконечно)
+     * @param mask Какие источники событий слушать (EVENT_INPUT | EVENT_RESIZE)
+     * @return Комбинация флагов EventFlags
+     */
+    static int wait(int64_t timeoutMicros, int mask = EVENT_INPUT | EVENT_RESIZE);
+};
+
+#endif
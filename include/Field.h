@@ -6,20 +6,74 @@
 #define FIELD_H
 
 #include "Figure.h"
+#include "BoardGeometry.h"
 #include <vector>
+#include <cstdint>
+
+/**
+ * @brief Строка битборда: бит j соответствует столбцу j
+ */
+typedef uint64_t BoardRow;
+
+/**
+ * @brief Вариант игрового поля
+ * @note Набор вариантов закрыт: вариант выбирается один раз в GameMenu,
+ *       а различия между полями хранятся в масках validBits и targetBits,
+ *       поэтому поклеточные проверки не требуют виртуальных вызовов
+ */
+enum FieldKind : uint8_t {
+    FIELD_CLASSIC, /**< Классическое прямоугольное поле */
+    FIELD_BUCKET,  /**< Поле-ведро, сужающееся кверху */
+    FIELD_PICTURE  /**< Поле режима "Собери картинку" */
+};
+
+/**
+ * @brief Кэш точки приземления фигуры
+ * 
+ * Хранит строку приземления для (тип, поворот, x) на конкретной версии поля.
+ * Если фигура из строки fromY долетает до landingY, то из любой строки
+ * между ними она долетает туда же, поэтому запись верна для всего диапазона.
+ */
+struct LandingCache {
+    uint32_t version;  /**< Версия поля, на которой посчитана запись */
+    PieceType type;    /**< Тип фигуры */
+    uint8_t rotation;  /**< Состояние поворота */
+    int16_t x;         /**< X-координата фигуры */
+    int16_t fromY;     /**< Самая верхняя строка, из которой проверено падение */
+    int16_t landingY;  /**< Строка, в которой фигура остановится */
+    bool valid;        /**< Запись заполнена */
+};
 
 /**
  * @brief Базовый класс игрового поля
  * 
  * Содержит логику размещения фигур, проверки столкновений и очистки линий.
+ * Занятость клеток хранится в виде битборда: одно машинное слово на строку.
+ * Стенки, дно и склоны ведра записаны в битборд как занятые клетки,
+ * а биты за правой границей поля установлены всегда, поэтому проверка
+ * столкновения сводится к нескольким операциям AND на строку фигуры.
+ * 
+ * Наследники (BucketField, PictureField) только задают вариант поля и его маски;
+ * методы, вызываемые для каждой клетки, невиртуальные и встраиваются.
  */
 class Field {
 protected:
-    bool isPictureMode;                    /**< Флаг режима "Собери картинку" */
-    std::vector<bool> fieldmatrix;        /**< Матрица занятых клеток */
-    std::vector<std::string> fieldcolors; /**< Матрица цветов клеток */
-    int fieldWidth = 22;                  /**< Ширина поля */
-    int fieldHeight = 22;                 /**< Высота поля */
+    FieldKind kind = FIELD_CLASSIC;       /**< Вариант поля */
+    std::vector<BoardRow> rowBits;        /**< Битборд занятых клеток (по слову на строку) */
+    std::vector<BoardRow> wallBits;       /**< Неигровые клетки каждой строки (стенки, склоны, дно) */
+    std::vector<BoardRow> validBits;      /**< Клетки, в которые можно ставить фигуру (isValidPosition) */
+    std::vector<BoardRow> targetBits;     /**< Целевая область картинки (пусто вне режима картинки) */
+    std::vector<uint8_t> fieldcolors;     /**< Матрица цветов клеток (индексы палитры) */
+    static constexpr int fieldWidth = BOARD_WIDTH;   /**< Ширина поля */
+    static constexpr int fieldHeight = BOARD_HEIGHT; /**< Высота поля */
+    BoardRow outsideMask;                 /**< Биты за правой границей поля (всегда заняты) */
+    uint32_t version = 0;                 /**< Увеличивается при каждом изменении клеток */
+    std::vector<uint8_t> rowFill;         /**< Количество занятых игровых клеток в строке */
+    std::vector<int> surfaceRow;          /**< Верхняя занятая игровая клетка столбца (или дно) */
+    std::vector<int> floorRow;            /**< Строка дна столбца: первая стенка под игровой областью */
+    int dirtyTop;                         /**< Верхняя строка, заполнявшаяся после последней очистки */
+    int dirtyBottom;                      /**< Нижняя такая строка (dirtyTop > dirtyBottom - таких нет) */
+    mutable LandingCache landingCache = LandingCache(); /**< Кэш getDropDistance() */
 
 public:
     /**
@@ -30,15 +84,23 @@ public:
     
     /**
      * @brief Виртуальный деструктор
+     * @note Единственный виртуальный метод: поле удаляется через указатель на Field
      */
     virtual ~Field() = default;
     
+    /**
+     * @brief Возвращает вариант поля
+     * @return Вариант, выбранный при создании поля
+     */
+    FieldKind getKind() const { return kind; }
+    
     /**
      * @brief Размещает фигуру на поле
      * @param figure Фигура для размещения
-     * @note Записывает фигуру в матрицу поля с сохранением цвета
+     * @note Записывает фигуру в матрицу поля с сохранением цвета.
+     *       Для поля картинки передает управление PictureField::placeFigure
      */
-    virtual void placeFigure(Figure& figure);
+    void placeFigure(Figure& figure);
     
     /**
      * @brief Проверяет, занята ли клетка
@@ -46,120 +108,247 @@ public:
      * @param j Номер столбца
      * @return true если клетка занята, false в противном случае
      */
-    bool getch(int i, int j);
+    bool getch(int i, int j) const {
+        return (i >= 0 && i < fieldHeight && j >= 0 && j < fieldWidth) ? ((rowBits[i] >> j) & 1) : true;
+    }
+    
+    /**
+     * @brief Возвращает строку битборда
+     * @param row Номер строки
+     * @return Слово с занятыми клетками строки; вне поля - все биты установлены
+     */
+    BoardRow getRowBits(int row) const {
+        return (row >= 0 && row < fieldHeight) ? rowBits[row] : ~BoardRow(0);
+    }
+    
+    /**
+     * @brief Возвращает игровые клетки строки
+     * @param row Номер строки
+     * @return Маска клеток, в которые можно ставить фигуру; вне поля - 0
+     */
+    BoardRow getValidBits(int row) const {
+        return (row >= 0 && row < fieldHeight) ? validBits[row] : 0;
+    }
+    
+    /**
+     * @brief Возвращает неигровые клетки строки
+     * @param row Номер строки
+     * @return Маска стенок, склонов, дна и битов за правой границей; вне поля - все биты
+     */
+    BoardRow getWallBits(int row) const {
+        return (row >= 0 && row < fieldHeight) ? wallBits[row] : ~BoardRow(0);
+    }
+    
+    /**
+     * @brief Возвращает весь битборд
+     * @return BOARD_HEIGHT слов подряд, как getRowBits(0..BOARD_HEIGHT - 1)
+     */
+    const BoardRow* getRows() const { return rowBits.data(); }
+    
+    /**
+     * @brief Проверяет, пересекается ли фигура с занятыми клетками
+     * @param figure Фигура (используется только ее форма)
+     * @param x X-координата левого верхнего угла фигуры
+     * @param y Y-координата левого верхнего угла фигуры
+     * @return true если хотя бы одна клетка фигуры занята или вне поля
+     */
+    bool collides(const Figure& figure, int x, int y) const;
+    
+    /**
+     * @brief Вычисляет глубину быстрого падения фигуры
+     * @param figure Фигура в ее текущей позиции
+     * @return Количество строк, на которое фигура может опуститься
+     * @note Результат кэшируется (см. LandingCache): призрак, дроп и гравитация
+     *       для одного состояния фигуры и поля считают его один раз.
+     *       Если фигура выше поверхности во всех своих столбцах, глубина
+     *       берется из surfaceRow без проверки столкновений
+     */
+    int getDropDistance(const Figure& figure) const;
+    
+    /**
+     * @brief Возвращает количество занятых игровых клеток строки
+     * @param row Номер строки
+     * @return Количество клеток без учета стенок
+     */
+    int getRowFill(int row) const {
+        return (row >= 0 && row < fieldHeight) ? rowFill[row] : 0;
+    }
+    
+    /**
+     * @brief Возвращает строку поверхности столбца
+     * @param col Номер столбца
+     * @return Верхняя занятая игровая клетка или строка дна, если столбец пуст
+     */
+    int getSurfaceRow(int col) const {
+        return (col >= 0 && col < fieldWidth) ? surfaceRow[col] : 0;
+    }
+    
+    /**
+     * @brief Возвращает высоту стопки в столбце над дном
+     * @param col Номер столбца
+     * @return 0 для пустого столбца и столбцов-стенок
+     */
+    int getColumnHeight(int col) const {
+        return (col >= 0 && col < fieldWidth) ? floorRow[col] - surfaceRow[col] : 0;
+    }
+    
+    /**
+     * @brief Возвращает версию поля
+     * @return Число, которое меняется при любом изменении клеток
+     */
+    uint32_t getVersion() const { return version; }
+    
+    /**
+     * @brief Проверяет, заполнена ли строка целиком
+     * @param row Номер строки
+     * @return true если все клетки строки (включая стенки) заняты
+     */
+    bool isRowFull(int row) const { return getRowBits(row) == ~BoardRow(0); }
     
     /**
      * @brief Устанавливает состояние клетки
      * @param i Номер строки
      * @param j Номер столбца
      * @param value true - клетка занята, false - свободна
-     * @param color Цвет клетки (по умолчанию пустая строка)
+     * @param color Индекс цвета клетки (COLOR_NONE - не менять цвет занятой клетки)
      */
-    void setch(int i, int j, bool value, const std::string& color = "");
+    void setch(int i, int j, bool value, uint8_t color = COLOR_NONE);
     
     /**
      * @brief Возвращает цвет клетки
      * @param i Номер строки
      * @param j Номер столбца
-     * @return ANSI-строка с цветом или пустая строка
+     * @return Индекс цвета в палитре или COLOR_NONE
      */
-    std::string getColor(int i, int j);
+    uint8_t getColor(int i, int j) const;
     
     /**
      * @brief Возвращает высоту поля
      * @return Высота поля в клетках
      */
-    virtual int getHeight();
+    int getHeight() const { return fieldHeight; }
     
     /**
      * @brief Возвращает ширину поля
      * @return Ширина поля в клетках
      */
-    virtual int getWidth();
+    int getWidth() const { return fieldWidth; }
     
     /**
      * @brief Возвращает ширину строки (для нестандартных полей)
      * @param row Номер строки
      * @return Ширина строки в клетках
-     * @note В базовом классе всегда возвращает fieldWidth
+     * @note Число клеток строки в маске validBits; для прямоугольных полей - fieldWidth
      */
-    virtual int getRowWidth(int row) { return fieldWidth; }
+    int getRowWidth(int row) const {
+        return (row >= 0 && row < fieldHeight) ? __builtin_popcountll(validBits[row]) : fieldWidth;
+    }
     
     /**
      * @brief Проверяет валидность позиции
      * @param row Номер строки
      * @param col Номер столбца
-     * @return true если позиция внутри поля и не занята стенкой
+     * @return true если позиция внутри поля (для ведра - внутри ширины строки)
      */
-    virtual bool isValidPosition(int row, int col);
+    bool isValidPosition(int row, int col) const {
+        return row >= 0 && row < fieldHeight && col >= 0 && col < fieldWidth &&
+               ((validBits[row] >> col) & 1);
+    }
+    
+    /**
+     * @brief Проверяет, находится ли позиция в целевой области картинки
+     * @param row Номер строки
+     * @param col Номер столбца
+     * @return true если позиция в целевой области (вне режима картинки - всегда false)
+     */
+    bool isInTargetArea(int row, int col) const {
+        return row >= 0 && row < fieldHeight && col >= 0 && col < fieldWidth &&
+               ((targetBits[row] >> col) & 1);
+    }
     
     /**
      * @brief Очищает заполненные линии
      * @return Количество очищенных линий
-     * @note Сдвигает вышележащие линии вниз
+     * @note Сдвигает вышележащие линии вниз за один проход; переменная ширина
+     *       строк ведра учитывается масками стенок wallBits
      */
-    virtual int clearFullLines();
-};
-
-/**
- * @brief Класс поля в форме ведра
- * 
- * Специализированное поле, сужающееся кверху (в форме ведра).
- * Переопределяет методы для работы с нестандартной геометрией.
- */
-class BucketField : public Field {
-private:
-    std::vector<int> rowWidths; /**< Ширина каждой строки (для сужающегося поля) */
+    int clearFullLines();
 
-public:
+protected:
     /**
-     * @brief Конструктор поля-ведра
-     * @note Инициализирует форму ведра
+     * @brief Запоминает текущие занятые клетки как стенки поля
+     * @note Вызывается конструкторами после построения границ
      */
-    BucketField();
+    void captureWalls();
     
     /**
-     * @brief Размещает фигуру с учетом формы ведра
-     * @param figure Фигура для размещения
-     * @override
+     * @brief Обновляет rowFill и surfaceRow при изменении игровой клетки
      */
-    virtual void placeFigure(Figure& figure) override;
+    void updateStats(int i, int j, bool value);
     
     /**
-     * @brief Возвращает ширину строки
-     * @param row Номер строки
-     * @return Ширина строки в клетках
-     * @override
+     * @brief Глубина падения по поверхности столбцов
+     * @return Глубина или -1, если нужна полная проверка столкновений
      */
-    virtual int getRowWidth(int row) override;
+    int getSkylineDropDistance(const Figure& figure) const;
     
     /**
-     * @brief Возвращает общую ширину поля
-     * @return Ширина поля в клетках
-     * @override
+     * @brief Пересчитывает rowFill, floorRow и surfaceRow по битборду
      */
-    virtual int getWidth() override { return fieldWidth; }
+    void recomputeStats();
     
     /**
-     * @brief Очищает заполненные линии с учетом формы ведра
-     * @return Количество очищенных линий
-     * @override
+     * @brief Очищает заполненные строки, проверяя только строки, куда ставились клетки
+     * @param firstRow Верхняя строка, которая может быть очищена
+     * @param lastRow Нижняя строка, которая может быть очищена
+     * @return Количество удаленных строк
      */
-    virtual int clearFullLines();
+    int clearDirtyLines(int firstRow, int lastRow);
     
     /**
-     * @brief Проверяет валидность позиции в ведре
-     * @param row Номер строки
-     * @param col Номер столбца
-     * @return true если позиция внутри текущей ширины строки
-     * @override
+     * @brief Удаляет заполненные строки и сжимает оставшиеся вниз за один проход
+     * @param firstRow Верхняя строка, которая может быть очищена
+     * @param lastRow Нижняя строка, которая может быть очищена
+     * @return Количество удаленных строк
+     * @note Каждая строка переносится целиком (слово битборда и строка цветов);
+     *       стенки строки-приемника сохраняются по маске wallBits
+     */
+    int compactRows(int firstRow, int lastRow);
+    
+    /**
+     * @brief Проверяет, будет ли строка src заполнена после переноса на место dst
+     */
+    bool isFullAfterMove(int src, int dst) const;
+    
+    /**
+     * @brief Переносит игровые клетки строки src в строку dst
+     */
+    void moveRow(int src, int dst);
+    
+    /**
+     * @brief Очищает игровые клетки строки, оставляя стенки
+     */
+    void clearRow(int row);
+};
+
+/**
+ * @brief Класс поля в форме ведра
+ * 
+ * Специализированное поле, сужающееся кверху (в форме ведра).
+ * Форма задается масками стенок и допустимых клеток при создании.
+ */
+class BucketField : public Field {
+public:
+    /**
+     * @brief Конструктор поля-ведра
+     * @note Инициализирует форму ведра
      */
-    virtual bool isValidPosition(int row, int col);
+    BucketField();
     
 private:
     /**
      * @brief Инициализирует форму ведра
-     * @note Задает ширину каждой строки для создания сужающейся формы
+     * @note Задает ширину каждой строки (маску validBits) для создания сужающейся формы
      */
     void initializeBucketShape();
 };
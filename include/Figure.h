@@ -5,88 +5,145 @@
 #ifndef FIGURE_H
 #define FIGURE_H
 
-#include <vector>
-#include <string>
+#include <cstdint>
+#include <type_traits>
+#include "Palette.h"
+#include "BoardGeometry.h"
 using namespace std;
 
+/**
+ * @brief Тип фигуры Тетриса
+ * @note Порядок совпадает с номерами, которые выдает генератор случайных фигур
+ */
+enum PieceType : uint8_t {
+    PIECE_O = 0,            /**< Квадрат */
+    PIECE_L,                /**< Фигура L */
+    PIECE_T,                /**< Фигура T */
+    PIECE_I,                /**< Палка */
+    PIECE_S,                /**< Фигура S */
+    PIECE_Z,                /**< Фигура Z */
+    PIECE_J,                /**< Фигура J */
+    PIECE_COUNT,            /**< Количество типов фигур */
+    PIECE_NONE = PIECE_COUNT /**< Пустая фигура (конструктор по умолчанию) */
+};
+
+/**
+ * @brief Одно состояние вращения фигуры
+ * 
+ * Форма задается квадратной рамкой size x size и масками строк:
+ * бит j в rows[i] установлен, если клетка (i, j) занята.
+ */
+struct PieceShape {
+    uint8_t size;    /**< Ширина и высота рамки фигуры */
+    uint8_t rows[4]; /**< Маски строк фигуры */
+};
+
+/**
+ * @brief Таблица состояний вращения всех фигур
+ * @note Индекс - [тип фигуры][состояние вращения]; определена в Figure.cpp
+ */
+extern const PieceShape PIECE_SHAPES[PIECE_COUNT + 1][4];
+
 /**
  * @brief Базовый класс фигуры Тетриса
  * 
  * Представляет абстрактную фигуру с возможностью вращения и перемещения.
- * Содержит информацию о форме, цвете, положении и состоянии вращения.
+ * Форма берется из таблицы состояний вращения по типу фигуры,
+ * поэтому вращение - это только смена индекса состояния.
+ * Фигура - тривиально копируемое значение из нескольких байт
+ * (тип, состояние вращения, координаты), копирование не выделяет память.
  */
 class Figure {
 protected:
-    std::vector<bool> matrix; /**< Матрица формы фигуры (true - клетка занята) */
-    string color;             /**< ANSI-строка с цветом фигуры */
-    int width = 2;            /**< Ширина фигуры в клетках */           
-    int height = 2;           /**< Высота фигуры в клетках */
-    int startx = 10;          /**< X-координата левого верхнего угла */
-    int starty = 1;           /**< Y-координата левого верхнего угла */
-    int rotationState = 0;    /**< Текущее состояние вращения (0-3) */
+    PieceType type = PIECE_NONE; /**< Тип фигуры */
+    uint8_t rotationState = 0;   /**< Текущее состояние вращения (0-3) */
+    int16_t startx = SPAWN_X;    /**< X-координата левого верхнего угла */
+    int16_t starty = SPAWN_Y;    /**< Y-координата левого верхнего угла */
 
 public:
     /**
      * @brief Конструктор по умолчанию
-     * @note Создает фигуру 2x2
+     * @note Создает пустую фигуру 2x2
      */
     Figure();
     
     /**
-     * @brief Возвращает константную ссылку на матрицу формы
-     * @return Константная ссылка на вектор bool
+     * @brief Конструктор фигуры заданного типа
+     * @param pieceType Тип фигуры
+     * @note Фигура создается в начальном состоянии вращения
      */
-    const std::vector<bool>& getMatrix() const { return matrix; }
+    explicit Figure(PieceType pieceType);
     
     /**
-     * @brief Устанавливает новую матрицу формы
-     * @param newMatrix Новая матрица формы
-     * @param newWidth Новая ширина
-     * @param newHeight Новая высота
+     * @brief Возвращает состояние вращения из таблицы форм
+     * @param pieceType Тип фигуры
+     * @param rotation Состояние вращения (0-3)
+     * @return Ссылка на элемент постоянной таблицы
      */
-    void setMatrix(const std::vector<bool>& newMatrix, int newWidth, int newHeight) {
-        matrix = newMatrix;
-        width = newWidth;
-        height = newHeight;
+    static const PieceShape& getShape(PieceType pieceType, int rotation) {
+        return PIECE_SHAPES[pieceType <= PIECE_NONE ? pieceType : PIECE_NONE][rotation & 3];
     }
     
+    /**
+     * @brief Возвращает цвет фигуры заданного типа
+     * @param pieceType Тип фигуры
+     * @return Индекс цвета в палитре
+     */
+    static uint8_t getPieceColor(PieceType pieceType);
+    
+    /**
+     * @brief Возвращает тип фигуры
+     * @return Тип фигуры
+     */
+    PieceType getType() const { return type; }
+    
     /**
      * @brief Проверяет, занята ли клетка в фигуре
      * @param i Номер строки в матрице фигуры
      * @param j Номер столбца в матрице фигуры
      * @return true если клетка занята
      */
-    bool getchar(int i, int j);
+    bool getchar(int i, int j) const;
+    
+    /**
+     * @brief Возвращает битовую маску строки фигуры
+     * @param i Номер строки в матрице фигуры
+     * @return Маска, в которой бит j установлен, если клетка (i, j) занята
+     */
+    unsigned getRowMask(int i) const {
+        const PieceShape& shape = getShape(type, rotationState);
+        return (i >= 0 && i < shape.size) ? shape.rows[i] : 0;
+    }
     
     /**
      * @brief Возвращает X-координату фигуры
      * @return Координата X
      */
-    int getstartx();
+    int getstartx() const { return startx; }
     
     /**
      * @brief Возвращает Y-координату фигуры
      * @return Координата Y
      */
-    int getstarty();
+    int getstarty() const { return starty; }
     
     /**
      * @brief Возвращает высоту фигуры
      * @return Высота в клетках
      */
-    int getHeight();
+    int getHeight() const { return getShape(type, rotationState).size; }
     
     /**
      * @brief Возвращает ширину фигуры
      * @return Ширина в клетках
      */
-    int getWidth();
+    int getWidth() const { return getShape(type, rotationState).size; }
     
     /**
      * @brief Возвращает цвет фигуры
-     * @return ANSI-строка с цветом
+     * @return Индекс цвета в палитре (см. Palette)
      */
-    string getcolor();
+    uint8_t getcolor() const { return getPieceColor(type); }
     
     /**
      * @brief Возвращает текущее состояние вращения
@@ -94,20 +151,27 @@ public:
      */
     int getRotationState() const { return rotationState; };
 
+
     /**
      * @brief Устанавливает позицию фигуры на поле
      * @param x Новая X-координата
      * @param y Новая Y-координата
      */
-    void setPosition(int x, int y);
+    void setPosition(int x, int y) {
+        startx = static_cast<int16_t>(x);
+        starty = static_cast<int16_t>(y);
+    }
     
     /**
      * @brief Вращает фигуру на 90 градусов по часовой стрелке
-     * @note Для каждой фигуры определены свои матрицы вращения
+     * @note Переключает индекс состояния в таблице форм, память не выделяется
      */
     void rotate();
 };
 
+static_assert(std::is_trivially_copyable<Figure>::value, "Figure должна копироваться без выделения памяти");
+static_assert(sizeof(Figure) <= 8, "Figure должна занимать несколько байт");
+
 /**
  * @brief Класс фигуры O (квадрат)
  * 
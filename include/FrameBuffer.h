@@ -0,0 +1,115 @@
+/**
+ * @file FrameBuffer.h
+ * @brief Заголовочный файл, содержащий объявление класса FrameBuffer - двойного буфера клеток поля
+ */
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Вид клетки на экране (два символа терминала)
+ */
+enum CellGlyph : uint8_t {
+    GLYPH_EMPTY = 0,  /**< Пустая клетка "  " */
+    GLYPH_BLOCK,      /**< Блок "██" */
+    GLYPH_GHOST,      /**< Призрачная фигура "▓▓" */
+    GLYPH_TARGET      /**< Контур картинки "▒▒" */
+};
+
+/**
+ * @brief Двойной буфер клеток игрового поля
+ * 
+ * ConsoleView рисует в задний буфер, а present() сравнивает его с
+ * передним (тем, что сейчас на экране) и выводит только изменившиеся
+ * клетки. Перемещение курсора выводится лишь при разрыве между
+ * изменившимися клетками, а короткие разрывы из пустых клеток
+ * заполняются пробелами. SGR-последовательность выводится только при
+ * смене цвета, поэтому подряд идущие клетки одного цвета идут одним
+ * отрезком, а сброс атрибутов - один раз в конце кадра.
+ * 
+ * @note Очистка экрана через TerminalHelper::clearScreen() меняет
+ *       поколение экрана, и FrameBuffer считает передний буфер пустым.
+ *       present() только дописывает кадр в TerminalOutput; на экран он
+ *       попадает при сбросе буфера в конце кадра.
+ */
+class FrameBuffer {
+public:
+    /**
+     * @brief Конструктор по умолчанию (пустой буфер)
+     */
+    FrameBuffer();
+    
+    /**
+     * @brief Меняет размер буфера в клетках
+     * @param rows Количество строк
+     * @param cols Количество столбцов (клеток, не символов)
+     * @note При изменении размера следующий кадр перерисовывается целиком
+     */
+    void resize(int rows, int cols);
+    
+    int getRows() const { return rows; }
+    int getCols() const { return cols; }
+    
+    /**
+     * @brief Записывает клетку в задний буфер
+     * @note Координаты вне буфера игнорируются
+     */
+    void setCell(int row, int col, uint8_t glyph, uint8_t color = 0);
+    
+    /**
+     * @brief Проверяет, соответствует ли передний буфер экрану
+     * @return true если экран был очищен или буфер сброшен после последнего кадра
+     */
+    bool isStale() const;
+    
+    /**
+     * @brief Сбрасывает передний буфер (например, после изменения размера терминала)
+     */
+    void invalidate();
+    
+    /**
+     * @brief Выводит разницу между задним и передним буфером
+     * @return Количество выведенных клеток
+     */
+    int present();
+
+private:
+    /**
+     * @brief Клетка буфера: вид и индекс цвета палитры
+     */
+    struct Cell {
+        uint8_t glyph;
+        uint8_t color;
+        
+        bool operator==(const Cell& other) const {
+            return glyph == other.glyph && color == other.color;
+        }
+        bool operator!=(const Cell& other) const { return !(*this == other); }
+    };
+    
+    /**
+     * @brief Выводит клетку, меняя цвет терминала только при необходимости
+     * @param cell Клетка
+     * @param activeColor Текущий цвет терминала (обновляется)
+     */
+    void writeCell(const Cell& cell, uint8_t& activeColor) const;
+    
+    /**
+     * @brief Проверяет, дешевле ли заполнить разрыв пробелами, чем переместить курсор
+     * @param row Строка
+     * @param fromCol Первая клетка разрыва
+     * @param toCol Клетка после разрыва
+     */
+    bool canBridge(int row, int fromCol, int toCol) const;
+    
+    std::vector<Cell> back;   /**< Кадр, который нужно показать */
+    std::vector<Cell> front;  /**< Кадр, который сейчас на экране */
+    int rows;
+    int cols;
+    unsigned generation;      /**< Поколение экрана, к которому относится front */
+    bool valid;               /**< false - содержимое экрана неизвестно */
+};
+
+#endif
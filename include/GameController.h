@@ -5,39 +5,60 @@
 #define GAMECONTROLLER_H
 
 #include "Field.h"
+#include "TetrisEngine.h"
+#include "BeamSearchBot.h"
 #include "ConsoleView.h"
 #include "Figure.h"
 #include "TerminalInput.h"
 #include "Score.h"
 #include "Settings.h"
+#include "GameTimer.h"
+#include "Replay.h"
+#include "TerminalOutput.h"
 
 /**
  * @brief Главный контроллер игры Тетрис
  * 
- * Управляет всем игровым процессом: обработкой ввода, логикой игры,
- * отображением, меню и взаимодействием с другими компонентами.
+ * Управляет всем игровым процессом: обработкой ввода, отображением, меню,
+ * таймингами и взаимодействием с другими компонентами. Правила игры
+ * (движение, фиксация, очки, уровни) выполняет TetrisEngine.
  */
 class GameController {
 private:
-    Field* field;
+    TetrisEngine engine;          /**< Правила и состояние текущей партии */
+    Field* field;                 /**< Поле текущей партии (принадлежит engine) */
     int prevFigureX;
     int prevFigureY;
-    Figure figure;
     ConsoleView view;
     TerminalInput input; 
     GameScore scoreSystem;
     Settings* settings;
     bool gameRunning; 
     int count;
-    int score;  
-    int linesClearedTotal; 
     std::string playerName; 
     bool gamePaused;
     bool isPictureMode;
     bool nameEntered;
+    int gameSession;              /**< Номер партии (меняется при каждом входе в GameMenu) */
+    uint64_t baseSeed;            /**< Зерно запуска: партия играет с зерном baseSeed + gameSession */
+    uint64_t loopIterations;      /**< Итерации игрового цикла без смены партии */
+    uint64_t loopAllocations;     /**< Выделения памяти за эти итерации (см. AllocCounter) */
+    OutputCounters frameOutput;   /**< Вывод в терминал за последний кадр */
+    OutputCounters loopOutput;    /**< Вывод в терминал за все итерации игрового цикла */
+    GameTimer gravityTimer;       /**< Планировщик тиков гравитации */
+    int64_t lockStartMicros;      /**< Момент, когда фигура легла на опору (-1 - висит) */
+    BeamSearchBot* bot;           /**< Бот автоигры (создается при первой автоигре) */
+    bool autoplay;                /**< Партией управляет бот (пункт меню "Автоигра") */
+    int64_t nextBotMoveMicros;    /**< Момент следующего действия бота */
+    ReplayRecorder replay;        /**< Повтор текущей партии (настройка REPLAY_RECORD) */
+    std::string replayPath;       /**< Файл повтора текущей партии */
 
 public:
-    GameController();
+    /**
+     * @brief Конструктор
+     * @param seed Зерно последовательности фигур (аргумент командной строки)
+     */
+    explicit GameController(uint64_t seed = 0);
     ~GameController();
     
     /**
@@ -47,8 +68,8 @@ public:
     void Input();
     
     /**
-     * @brief Обновляет позицию фигуры
-     * @note Проверяет столкновения и создает новую фигуру при необходимости
+     * @brief Фиксирует фигуру, стоящую на опоре
+     * @note Выполняет ACTION_LOCK движка и отображает его результат
      */
     void NewPosition();
     
@@ -74,10 +95,20 @@ public:
     
     /**
      * @brief Автоматическое перемещение фигуры вниз
-     * @note Вызывается по таймеру или в игровом цикле
+     * @note Вызывается в игровом цикле: применяет наступившие тики гравитации
+     *       и фиксирует фигуру по истечении задержки фиксации
      */
     void AutoMoveDown();
     
+    /**
+     * @brief Выполняет очередное действие бота в режиме автоигры
+     * @note Бот действует не чаще, чем раз в getBotInterval() микросекунд.
+     *       Положение фигуры выбирается лучевым поиском по очереди
+     *       предпросмотра (настройки AUTOPLAY_DEPTH, AUTOPLAY_BEAM,
+     *       AUTOPLAY_BUDGET) на всех ядрах
+     */
+    void AutoPlay();
+    
     /**
      * @brief Управление через терминал
      * @note Альтернативное название для Input()
@@ -113,12 +144,6 @@ public:
      */
     void ShowCurrentSettings();
     
-    /**
-     * @brief Добавляет очки к счету
-     * @param points Количество добавляемых очков
-     */
-    void addPoints(int points);
-    
     /**
      * @brief Показывает главное меню игры
      * @return true если игра должна начаться, false для выхода
@@ -127,7 +152,8 @@ public:
     
     /**
      * @brief Обновляет уровень игры
-     * @note Повышает уровень при достижении нужного количества линий
+     * @note Переносит уровень движка в настройки (скорость гравитации)
+     *       и сообщает о новом уровне
      */
     void updateLevel();
     
@@ -147,6 +173,19 @@ public:
      * @param isPictureModeGameOver true если игра в режиме "Собери картинку"
      */
     void showGameOverScreen(bool isPictureModeGameOver);
+    
+    /**
+     * @brief Возвращает количество выделений памяти в игровом цикле
+     * @return Сумма выделений за итерации, не сменившие партию
+     * @note Ненулевое значение возможно только при сборке с TETRIS_COUNT_ALLOCATIONS
+     */
+    uint64_t getLoopAllocations() const { return loopAllocations; }
+    
+    /**
+     * @brief Возвращает вывод в терминал за последний кадр игрового цикла
+     * @return Количество вызовов write() и байт (см. TerminalOutput)
+     */
+    OutputCounters getFrameOutput() const { return frameOutput; }
 private:
     /**
      * @brief Быстрое падение фигуры (дроп)
@@ -154,12 +193,43 @@ private:
      */
     void DropFigure();
     
+    /**
+     * @brief Применяет действие к текущей фигуре и обновляет экран
+     * @param action Действие (от клавиатуры или бота)
+     */
+    void applyAction(EngineAction action);
+    
     /**
      * @brief Проверяет возможность поворота фигуры
      * @return true если поворот возможен
      */
     bool CanRotate();
     
+    /**
+     * @brief Отображает результат фиксации фигуры
+     * @param result Результат шага движка
+     * @note Перерисовывает поле после очистки линий, выводит сообщения
+     *       режима картинки и показывает экран окончания игры
+     */
+    void showLockResult(const StepResult& result);
+    
+    /**
+     * @brief Начинает партию в движке
+     * @param mode Режим партии
+     * @note Зерно партии - baseSeed + gameSession, алгоритм выдачи фигур -
+     *       настройка RANDOMIZER, поэтому при одном seed последовательности
+     *       фигур одинаковы на любой машине. При REPLAY_RECORD = 1 начинает
+     *       запись повтора: действия движка и тики гравитации между ними
+     */
+    void startGame(GameMode mode);
+    
+    /**
+     * @brief Сохраняет повтор партии, если он записывается
+     * @note Файл tetris_replay_<зерно партии>.ttr в текущем каталоге.
+     *       Вызывается в конце партии, при новой игре и при выходе
+     */
+    void finishReplay();
+    
     /**
      * @brief Показывает текущий счет и управление
      */
@@ -178,6 +248,26 @@ private:
      * @note Сбрасывает состояние игры и показывает меню
      */
     void returnToMenu();
+    
+    /**
+     * @brief Возвращает интервал гравитации для текущего уровня
+     * @return Интервал в микросекундах (настройка GRAVITY_SPEED)
+     */
+    int64_t getGravityInterval() const;
+    
+    /**
+     * @brief Возвращает интервал между действиями бота
+     * @return Настройка AUTOPLAY_DELAY, но не больше четверти интервала
+     *         гравитации: на быстрых уровнях бот успевает довести фигуру
+     */
+    int64_t getBotInterval() const;
+    
+    /**
+     * @brief Возвращает время до ближайшего события игрового цикла
+     * @param now Текущее время монотонных часов
+     * @return Микросекунды до тика гравитации или истечения задержки фиксации
+     */
+    int64_t getTimeUntilNextEvent(int64_t now) const;
 
 };
 
@@ -0,0 +1,78 @@
+/**
+ * @file GameTimer.h
+ * @brief Заголовочный файл, содержащий объявление класса GameTimer - планировщика гравитации
+ */
+#ifndef GAMETIMER_H
+#define GAMETIMER_H
+
+#include <cstdint>
+
+/**
+ * @brief Планировщик с фиксированным шагом на монотонных часах
+ * 
+ * Отсчитывает тики гравитации по clock_gettime(CLOCK_MONOTONIC).
+ * Дедлайны тиков абсолютные: время отрисовки и ожидания ввода не сдвигает
+ * расписание, а пропущенные тики выдаются при следующем вызове consumeTicks().
+ */
+class GameTimer {
+private:
+    int64_t intervalMicros; /**< Интервал между тиками в микросекундах */
+    int64_t nextTick;       /**< Абсолютное время следующего тика */
+    bool running;           /**< Запущен ли таймер */
+
+public:
+    /**
+     * @brief Конструктор
+     * @note Таймер создается остановленным
+     */
+    GameTimer();
+    
+    /**
+     * @brief Возвращает текущее время монотонных часов
+     * @return Время в микросекундах
+     */
+    static int64_t nowMicros();
+    
+    /**
+     * @brief Запускает таймер заново
+     * @param interval Интервал между тиками в микросекундах
+     * @note Первый тик наступит через interval от текущего момента
+     */
+    void start(int64_t interval);
+    
+    /**
+     * @brief Останавливает таймер
+     */
+    void stop() { running = false; }
+    
+    /**
+     * @brief Проверяет, запущен ли таймер
+     * @return true если таймер запущен
+     */
+    bool isRunning() const { return running; }
+    
+    /**
+     * @brief Меняет интервал без сброса фазы
+     * @param interval Новый интервал в микросекундах
+     * @note Уже назначенный тик не переносится, новый интервал действует со следующего
+     */
+    void setInterval(int64_t interval);
+    
+    /**
+     * @brief Забирает наступившие тики
+     * @param now Текущее время (см. nowMicros())
+     * @param maxTicks Максимум тиков за один вызов
+     * @return Количество тиков, наступивших к моменту now
+     * @note Если отставание больше maxTicks, расписание синхронизируется с now
+     */
+    int consumeTicks(int64_t now, int maxTicks);
+    
+    /**
+     * @brief Возвращает время до следующего тика
+     * @param now Текущее время
+     * @return Микросекунды до тика (0 если тик уже наступил, -1 если таймер остановлен)
+     */
+    int64_t getTimeUntilNextTick(int64_t now) const;
+};
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * @file HeuristicBot.h
+ * @brief Заголовочный файл, содержащий объявление класса HeuristicBot - бота, оценивающего положения фигуры
+ */
+#ifndef HEURISTICBOT_H
+#define HEURISTICBOT_H
+
+#include "BoardFeatures.h"
+#include "Field.h"
+#include "Figure.h"
+#include "MoveGenerator.h"
+#include "TetrisEngine.h"
+#include <vector>
+
+/**
+ * @brief Веса признаков
+ * @note Значения по умолчанию подобраны tetris_tune в классическом режиме
+ *       со случайной выдачей фигур (30 поколений по 100 векторов,
+ *       24 партии до 1000 фигур). Все признаки поверхности штрафуются,
+ *       сильнее всего - высота, дыры и переходы вдоль столбцов: бот держит
+ *       поле низким и ровным, а колодцы, в том числе у стенок, оставляет
+ *       только под очистку линий
+ */
+struct BotWeights {
+    float aggregateHeight = -1.8f;
+    float holes = -1.685f;
+    float bumpiness = -0.386f;
+    float linesCleared = 0.335f;
+    float wells = -0.179f;
+    float rowTransitions = -0.248f;
+    float columnTransitions = -0.809f;
+};
+
+/**
+ * @brief Бот, выбирающий положение фигуры по взвешенной сумме признаков
+ *
+ * Положения перечисляет MoveGenerator. Поле после каждого положения
+ * собирается в общий буфер строк (строка row положения i - слово
+ * row * N + i), и признаки всех положений считаются одним вызовом
+ * extractFeatures: с AVX2 - по четыре положения за проход по строкам.
+ * Положение, очищающее линии, сначала разыгрывается на копии поля.
+ */
+class HeuristicBot {
+private:
+    BotWeights weights;                           /**< Веса признаков */
+    MoveGenerator generator;                      /**< Генератор положений */
+    Field scratch;                                /**< Копия поля для положений с очисткой линий */
+    std::vector<EngineAction> path;               /**< Путь к выбранному положению */
+    std::vector<BoardFeatures> placementFeatures; /**< Признаки положений последнего перебора */
+    std::vector<float> placementScores;           /**< Оценки положений последнего перебора */
+    std::vector<int> placementLines;              /**< Очищено линий положениями последнего перебора */
+    std::vector<BoardRow> candidateRows;          /**< Поля после положений: candidateRows[row * N + i] */
+
+public:
+    /**
+     * @brief Конструктор
+     * @param botWeights Веса признаков
+     */
+    explicit HeuristicBot(const BotWeights& botWeights = BotWeights());
+
+    const BotWeights& getWeights() const { return weights; }
+    void setWeights(const BotWeights& botWeights) { weights = botWeights; }
+
+    /**
+     * @brief Выбирает положение и строит путь к нему
+     * @param field Поле
+     * @param figure Текущая фигура
+     * @return Действия до фиксации (последнее - ACTION_HARD_DROP);
+     *         пусто, если фигуре некуда встать
+     * @note Ссылка действительна до следующего вызова
+     */
+    const std::vector<EngineAction>& plan(const Field& field, const Figure& figure);
+
+    /**
+     * @brief Оценивает все положения фигуры
+     * @param field Поле
+     * @param figure Текущая фигура
+     * @return Количество положений
+     * @note Положения, их признаки и оценки доступны через getPlacements(),
+     *       getPlacementFeatures() и getPlacementScores() до следующего вызова
+     */
+    int evaluatePlacements(const Field& field, const Figure& figure);
+
+    const std::vector<Placement>& getPlacements() const { return generator.getPlacements(); }
+    const std::vector<BoardFeatures>& getPlacementFeatures() const { return placementFeatures; }
+    const std::vector<float>& getPlacementScores() const { return placementScores; }
+
+    /**
+     * @brief Восстанавливает путь к положению из getPlacements()
+     */
+    void getPath(const Placement& placement, std::vector<EngineAction>& actions) const {
+        generator.getPath(placement, actions);
+    }
+
+    /**
+     * @brief Возвращает первое действие лучшего пути
+     * @note Для автоигры: план строится заново перед каждым действием,
+     *       поэтому тики гравитации между действиями не сбивают бота
+     */
+    EngineAction nextAction(const Field& field, const Figure& figure);
+
+    /**
+     * @brief Оценивает признаки
+     * @param features Признаки
+     * @return Взвешенная сумма (больше - лучше)
+     */
+    float evaluate(const BoardFeatures& features) const;
+
+    /**
+     * @brief Считает признаки поля целиком
+     * @param field Поле
+     * @return Признаки (linesCleared = 0)
+     */
+    static BoardFeatures measure(const Field& field);
+
+private:
+    /**
+     * @brief Ставит фигуру в поле положения в буфере candidateRows
+     * @param field Поле до фиксации (его строки уже записаны в буфер)
+     * @param figure Фигура в положении фиксации
+     * @param index Номер положения
+     * @param count Количество положений (расстояние между строками в буфере)
+     * @return Очищено линий
+     */
+    int placeCandidate(const Field& field, const Figure& figure, int index, int count);
+};
+
+#endif
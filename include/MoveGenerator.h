@@ -0,0 +1,136 @@
+/**
+ * @file MoveGenerator.h
+ * @brief Заголовочный файл, содержащий объявление класса MoveGenerator - генератора достижимых положений фигуры
+ */
+#ifndef MOVEGENERATOR_H
+#define MOVEGENERATOR_H
+
+#include "Field.h"
+#include "Figure.h"
+#include "TetrisEngine.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Положение, в котором фигура может быть зафиксирована
+ */
+struct Placement {
+    Figure figure;       /**< Фигура в положении фиксации (тип, поворот, координаты) */
+    int16_t state;                                 /**< Состояние поиска, из которого выполняется ACTION_HARD_DROP */
+    uint16_t pathLength; /**< Длина кратчайшей последовательности действий, включая ACTION_HARD_DROP */
+};
+
+/**
+ * @brief Генератор всех положений фиксации фигуры
+ *
+ * Поиск в ширину по состояниям (поворот, строка, столбец) с действиями
+ * ACTION_LEFT, ACTION_RIGHT, ACTION_ROTATE и ACTION_SOFT_DROP по правилам
+ * TetrisEngine::step(); каждое состояние может завершиться ACTION_HARD_DROP.
+ * Гравитация между действиями не учитывается: последовательность
+ * выполняется быстрее, чем проходит тик.
+ *
+ * Состояние задается левой верхней занятой клеткой фигуры, а не углом ее
+ * рамки, поэтому столбцы умещаются в одно слово BoardRow. Для каждой
+ * пары (поворот, строка) заранее строится маска свободных столбцов
+ * сдвигами строк битборда, и проверка хода - это проверка одного бита.
+ * Положения с одинаковыми клетками (например, S в поворотах 0 и 2)
+ * считаются одним положением.
+ *
+ * Объект хранит буферы поиска и переиспользуется между вызовами:
+ * после первого вызова generate() память не выделяется.
+ */
+class MoveGenerator {
+public:
+    static constexpr int ROTATIONS = 4;                                   /**< Состояний поворота */
+    static constexpr int STATE_COUNT = ROTATIONS * BOARD_HEIGHT * 64;     /**< Размер пространства состояний */
+
+private:
+    /**
+     * @brief Форма одного поворота, прижатая к левому верхнему углу
+     */
+    struct ShapeInfo {
+        int minRow;       /**< Первая занятая строка рамки */
+        int minCol;       /**< Первый занятый столбец рамки */
+        int height;       /**< Число строк с клетками */
+        int width;        /**< Число столбцов с клетками */
+        int canonical;    /**< Меньший поворот с теми же клетками */
+        unsigned rows[4]; /**< Маски строк, сдвинутые на minRow и minCol */
+    };
+
+    PieceType type;                                /**< Тип фигуры текущего поиска */
+    int rotationCount;                             /**< Различимых поворотов (1 для O) */
+    ShapeInfo shapes[ROTATIONS];                   /**< Формы поворотов */
+    BoardRow freeBits[ROTATIONS][BOARD_HEIGHT];    /**< Столбцы, где фигура не пересекается с полем */
+    BoardRow visitedBits[ROTATIONS][BOARD_HEIGHT]; /**< Посещенные состояния */
+    BoardRow lockedBits[ROTATIONS][BOARD_HEIGHT];  /**< Найденные положения фиксации */
+    int16_t landingFrom[ROTATIONS][64];            /**< Кэш приземления: верхняя проверенная строка */
+    int16_t landingRow[ROTATIONS][64];             /**< Кэш приземления: строка остановки */
+    std::vector<int16_t> parent;                   /**< Предыдущее состояние (-1 для начального) */
+    std::vector<uint8_t> parentAction;             /**< Действие, которым состояние достигнуто */
+    std::vector<uint16_t> depth;                   /**< Длина пути до состояния */
+    std::vector<int16_t> queue;                    /**< Очередь поиска */
+    std::vector<Placement> placements;             /**< Результат последнего вызова */
+
+public:
+    MoveGenerator();
+
+    /**
+     * @brief Находит все положения фиксации фигуры
+     * @param field Поле
+     * @param figure Фигура в начальной позиции
+     * @return Количество найденных положений
+     * @note Положения перечисляются в порядке длины пути; если фигура
+     *       в начальной позиции пересекается с полем, положений нет
+     */
+    int generate(const Field& field, const Figure& figure);
+
+    /**
+     * @brief Возвращает положения последнего вызова generate()
+     */
+    const std::vector<Placement>& getPlacements() const { return placements; }
+
+    /**
+     * @brief Восстанавливает кратчайшую последовательность действий
+     * @param placement Положение из getPlacements()
+     * @param path Выходной параметр: действия от начальной позиции до фиксации
+     * @note Последнее действие - ACTION_HARD_DROP; повторение пути через
+     *       TetrisEngine::step() фиксирует фигуру именно в placement.figure
+     */
+    void getPath(const Placement& placement, std::vector<EngineAction>& path) const;
+
+private:
+    /**
+     * @brief Заполняет shapes для типа фигуры
+     */
+    void prepareShapes(PieceType pieceType);
+
+    /**
+     * @brief Строит маски свободных столбцов freeBits
+     */
+    void buildFreeBits(const Field& field);
+
+    /**
+     * @brief Проверяет, свободна ли позиция
+     * @param rot Поворот
+     * @param row Строка верхней занятой клетки
+     * @param col Столбец левой занятой клетки
+     */
+    bool isFree(int rot, int row, int col) const {
+        return row >= 0 && row < BOARD_HEIGHT && col >= 0 && col < 64 &&
+               ((freeBits[rot][row] >> col) & 1);
+    }
+
+    /**
+     * @brief Возвращает строку, в которой остановится фигура, падая из row
+     */
+    int getLandingRow(int rot, int row, int col);
+
+    /**
+     * @brief Добавляет состояние в очередь, если оно еще не посещено
+     */
+    void visit(int rot, int row, int col, int from, EngineAction action);
+
+    static int encode(int rot, int row, int col) { return (rot * BOARD_HEIGHT + row) * 64 + col; }
+};
+
+#endif
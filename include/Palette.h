@@ -0,0 +1,43 @@
+/**
+ * @file Palette.h
+ * @brief Заголовочный файл, содержащий индексы палитры цветов клеток и таблицу SGR-последовательностей
+ */
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include <cstdint>
+
+/**
+ * @brief Индекс цвета клетки в палитре
+ * 
+ * Поле и фигуры хранят цвет одним байтом, а ANSI-строка выбирается
+ * из таблицы Palette только при отрисовке.
+ */
+enum CellColor : uint8_t {
+    COLOR_NONE = 0,  /**< Пустая клетка */
+    COLOR_WALL,      /**< Стенка или дно поля */
+    COLOR_RED,       /**< Красный (\x1b[31m) */
+    COLOR_GREEN,     /**< Зеленый (\x1b[32m) */
+    COLOR_YELLOW,    /**< Желтый (\x1b[33m) */
+    COLOR_BLUE,      /**< Синий (\x1b[34m) */
+    COLOR_MAGENTA,   /**< Фиолетовый (\x1b[35m) */
+    COLOR_CYAN,      /**< Голубой (\x1b[36m) */
+    COLOR_WHITE,     /**< Белый (\x1b[37m) */
+    COLOR_SHADOW,    /**< Серый (\x1b[90m): призрачная фигура и контур картинки */
+    COLOR_COUNT      /**< Количество цветов в палитре */
+};
+
+/**
+ * @brief Статическая таблица SGR-последовательностей палитры
+ */
+class Palette {
+public:
+    /**
+     * @brief Возвращает SGR-последовательность для цвета
+     * @param color Индекс цвета в палитре
+     * @return ANSI-строка с цветом (стенки рисуются белым, пустая клетка - пустая строка)
+     */
+    static const char* getSGR(uint8_t color);
+};
+
+#endif
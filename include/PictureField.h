@@ -30,11 +30,11 @@ const int PICTURE_TRIANGLE = 7;
  */
 class PictureField : public Field {
 private:
-    std::vector<bool> targetPicture;
     std::vector<bool> currentPicture;
-    std::vector<std::string> pictureColors;
+    std::vector<uint8_t> pictureColors;
     int currentPictureType;
     bool gameOver;
+    bool touchedBorder;
     
     /**
      * @brief Загружает картинку указанного типа
@@ -91,22 +91,11 @@ public:
     
     /**
      * @brief Размещает фигуру на поле с проверкой границ картинки
-     * @note Завершает игру при выходе за границы целевой области
+     * @note Завершает игру при выходе за границы целевой области или при
+     *       собранной картинке. Сообщения игроку выводит GameController.
+     *       Вызывается из Field::placeFigure для поля варианта FIELD_PICTURE
      */
-    virtual void placeFigure(Figure& figure) override;
-    
-    /**
-     * @brief Проверяет валидность позиции на поле
-     * @return true если позиция внутри поля
-     * @override
-     */
-    virtual bool isValidPosition(int row, int col) override;
-    
-    /**
-     * @brief Проверяет, находится ли позиция в целевой области
-     * @return true если позиция в целевой области картинки
-     */
-    bool isInTargetArea(int row, int col) const;
+    void placeFigure(Figure& figure);
     
     /**
      * @brief Проверяет, полностью ли собрана картинка
@@ -125,12 +114,24 @@ public:
      */
     std::string getPictureName() const;
     
+    /**
+     * @brief Возвращает тип текущей картинки
+     * @return Одна из констант PICTURE_*
+     */
+    int getPictureType() const { return currentPictureType; }
+    
     /**
      * @brief Проверяет, завершена ли игра
      * @return true если игра завершена
      */
     bool isGameOver() const { return gameOver; }
     
+    /**
+     * @brief Проверяет, выходила ли фигура за границы картинки
+     * @return true если часть фигуры легла вне целевой области
+     */
+    bool hasTouchedBorder() const { return touchedBorder; }
+    
     /**
      * @brief Устанавливает состояние завершения игры
      * @param over Новое состояние
@@ -162,4 +163,13 @@ public:
     
 };
 
+/**
+ * @brief Приводит поле к PictureField без RTTI
+ * @param field Указатель на поле (может быть nullptr)
+ * @return Указатель на поле картинки или nullptr для других вариантов поля
+ */
+inline PictureField* asPictureField(Field* field) {
+    return (field && field->getKind() == FIELD_PICTURE) ? static_cast<PictureField*>(field) : nullptr;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,124 @@
+/**
+ * @file Randomizer.h
+ * @brief Заголовочный файл, содержащий генератор псевдослучайных чисел и генератор последовательности фигур
+ */
+#ifndef RANDOMIZER_H
+#define RANDOMIZER_H
+
+#include "Figure.h"
+#include <cstdint>
+
+/**
+ * @brief Генератор псевдослучайных чисел xoshiro256**
+ *
+ * Состояние - четыре 64-битных слова, заполняемые из зерна через splitmix64.
+ * Последовательность задается только зерном и одинакова на любой платформе
+ * и libc, в отличие от rand().
+ */
+class Xoshiro256 {
+private:
+    uint64_t state[4]; /**< Состояние генератора */
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    /**
+     * @brief Конструктор
+     * @param seed Зерно
+     */
+    explicit Xoshiro256(uint64_t seed = 0) { reseed(seed); }
+
+    /**
+     * @brief Задает зерно
+     * @param seed Зерно (любое, включая 0)
+     */
+    void reseed(uint64_t seed);
+
+    /**
+     * @brief Возвращает следующее 64-битное число
+     */
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    /**
+     * @brief Возвращает равномерное число из [0, bound)
+     * @param bound Верхняя граница (больше 0)
+     * @note Умножение со сдвигом с отбрасыванием (метод Лемира), без смещения
+     */
+    uint32_t nextBelow(uint32_t bound);
+};
+
+/**
+ * @brief Алгоритм выдачи фигур
+ */
+enum RandomizerKind : uint8_t {
+    RANDOMIZER_RANDOM,  /**< Каждая фигура независимо и равновероятно */
+    RANDOMIZER_BAG7,    /**< Перемешанный мешок из семи разных фигур */
+    RANDOMIZER_HISTORY, /**< Повторный выбор, если фигура есть среди последних четырех */
+    RANDOMIZER_COUNT    /**< Количество алгоритмов */
+};
+
+/**
+ * @brief Генератор последовательности фигур с очередью предпросмотра
+ *
+ * Принадлежит одной партии: у каждого движка свой поток чисел,
+ * поэтому параллельные партии независимы и воспроизводимы.
+ * Очередь предпросмотра заполняется заранее, peek() не меняет состояние.
+ */
+class Randomizer {
+public:
+    static constexpr int PREVIEW_SIZE = 6;  /**< Длина очереди предпросмотра */
+    static constexpr int HISTORY_SIZE = 4;  /**< Длина истории RANDOMIZER_HISTORY */
+    static constexpr int HISTORY_ROLLS = 6; /**< Попыток выбрать фигуру не из истории */
+
+private:
+    Xoshiro256 rng;                      /**< Источник случайных чисел */
+    RandomizerKind kind;                 /**< Алгоритм выдачи */
+    PieceType preview[PREVIEW_SIZE];     /**< Кольцевая очередь предпросмотра */
+    int previewHead;                     /**< Индекс ближайшей фигуры в очереди */
+    PieceType bag[PIECE_COUNT];          /**< Текущий мешок RANDOMIZER_BAG7 */
+    int bagPos;                          /**< Сколько фигур мешка уже выдано */
+    PieceType history[HISTORY_SIZE];     /**< Последние фигуры RANDOMIZER_HISTORY */
+
+public:
+    Randomizer();
+
+    /**
+     * @brief Начинает новую последовательность
+     * @param seed Зерно
+     * @param randomizerKind Алгоритм выдачи
+     */
+    void reset(uint64_t seed, RandomizerKind randomizerKind);
+
+    /**
+     * @brief Выдает следующую фигуру и дополняет очередь предпросмотра
+     */
+    PieceType next();
+
+    /**
+     * @brief Возвращает фигуру из очереди предпросмотра
+     * @param index 0 - фигура, которую выдаст следующий next()
+     */
+    PieceType peek(int index) const {
+        return preview[(previewHead + index) % PREVIEW_SIZE];
+    }
+
+    RandomizerKind getKind() const { return kind; }
+
+private:
+    /**
+     * @brief Генерирует фигуру выбранным алгоритмом
+     */
+    PieceType generate();
+};
+
+#endif
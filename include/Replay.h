@@ -0,0 +1,147 @@
+/**
+ * @file Replay.h
+ * @brief Заголовочный файл, содержащий запись и чтение повторов партии (журнал действий движка)
+ *
+ * Формат файла (все числа без знака - varint LEB128, со знаком - zigzag):
+ * - "TTRP", версия (байт)
+ * - режим, тип картинки (0 - не картинка), алгоритм выдачи фигур,
+ *   ширина и высота поля - по байту; зерно партии (varint)
+ * - количество настроек (varint), для каждой: длина имени (байт),
+ *   имя, значение (zigzag)
+ * - записи: varint((тики с прошлой записи << 3) | действие), где
+ *   действие - EngineAction (0-6); код 7 - конец партии, за ним
+ *   счет, линии и количество фигур (varint)
+ *
+ * Тик - один тик гравитации: повтор не зависит от скорости падения и
+ * времени, движок воспроизводит партию, применяя между записями
+ * накопившиеся тики и затем действие записи. Запись внутри тика - один
+ * байт, поэтому партия занимает несколько килобайт.
+ */
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "Randomizer.h"
+#include "TetrisEngine.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Заголовок повтора
+ */
+struct ReplayHeader {
+    GameMode mode = MODE_CLASSIC;                 /**< Режим партии */
+    int pictureType = 0;                          /**< Картинка (PICTURE_*), 0 - не режим картинки */
+    RandomizerKind randomizer = RANDOMIZER_RANDOM; /**< Алгоритм выдачи фигур */
+    int boardWidth = BOARD_WIDTH;                 /**< Ширина поля сборки, в которой записан повтор */
+    int boardHeight = BOARD_HEIGHT;               /**< Высота поля */
+    uint64_t seed = 0;                            /**< Зерно партии */
+    std::vector<std::pair<std::string, int> > settings; /**< Настройки партии (для справки) */
+};
+
+/**
+ * @brief Запись повтора: действие после tick тиков гравитации от начала партии
+ */
+struct ReplayEvent {
+    uint64_t tick;
+    EngineAction action;
+};
+
+/**
+ * @brief Итог партии из записи конца повтора
+ */
+struct ReplayTotals {
+    bool present = false;                         /**< Запись конца есть (партия записана до конца) */
+    int64_t score = 0;
+    int lines = 0;
+    int pieces = 0;
+};
+
+/**
+ * @brief Записывает повтор партии в память и сохраняет его в файл в конце партии
+ *
+ * Запись действия - несколько целочисленных операций и добавление 1-3 байт
+ * в заранее выделенный буфер: файл пишется только в finish(), поэтому
+ * ввод и игровой цикл не ждут диска.
+ */
+class ReplayRecorder {
+private:
+    std::vector<uint8_t> buffer;                  /**< Заголовок и записи */
+    uint64_t tick;                                /**< Тиков гравитации от начала партии */
+    uint64_t lastTick;                            /**< Тик последней записи */
+    bool recording;                               /**< Партия записывается */
+
+public:
+    ReplayRecorder();
+
+    /**
+     * @brief Начинает запись партии (предыдущая запись отбрасывается)
+     * @param header Заголовок
+     */
+    void start(const ReplayHeader& header);
+
+    /**
+     * @brief Учитывает тики гравитации
+     * @param ticks Количество тиков, переданных движку
+     */
+    void addTicks(int ticks) {
+        tick += static_cast<uint64_t>(ticks);
+    }
+
+    /**
+     * @brief Записывает действие, переданное движку
+     * @param action Действие (ACTION_GRAVITY не записывается: гравитация - это тики)
+     */
+    void record(EngineAction action) {
+        if (!recording) return;
+        appendVarint(((tick - lastTick) << 3) | static_cast<uint64_t>(action));
+        lastTick = tick;
+    }
+
+    /**
+     * @brief Завершает запись и сохраняет повтор
+     * @param path Путь к файлу
+     * @param engine Движок партии (итог пишется в запись конца)
+     * @return false, если запись не шла или файл не записан
+     */
+    bool finish(const std::string& path, const TetrisEngine& engine);
+
+    bool isRecording() const { return recording; }
+
+    /**
+     * @brief Возвращает записанные байты (заголовок и записи)
+     */
+    const std::vector<uint8_t>& getData() const { return buffer; }
+
+private:
+    void appendVarint(uint64_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        buffer.push_back(static_cast<uint8_t>(value));
+    }
+};
+
+/**
+ * @brief Читает повтор из файла
+ * @param path Путь к файлу
+ * @param header Заголовок
+ * @param events Записи по порядку
+ * @param totals Итог из записи конца (present = false, если ее нет)
+ * @return false, если файл не открыт или не является повтором этой версии
+ */
+bool readReplay(const std::string& path, ReplayHeader& header,
+                std::vector<ReplayEvent>& events, ReplayTotals& totals);
+
+/**
+ * @brief Воспроизводит повтор в движке
+ * @param engine Движок (начинает новую партию)
+ * @param header Заголовок
+ * @param events Записи
+ * @note Между записями применяются накопившиеся тики гравитации
+ */
+void playReplay(TetrisEngine& engine, const ReplayHeader& header, const std::vector<ReplayEvent>& events);
+
+#endif
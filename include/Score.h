@@ -6,6 +6,7 @@
 #ifndef SCORESYSTEM_H
 #define SCORESYSTEM_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <fstream>
@@ -18,7 +19,7 @@
  */
 struct HighScore {
     std::string playerName;
-    int score;
+    int64_t score;
     std::string date;
 };
 
@@ -56,7 +57,7 @@ public:
      * @brief Добавляет новый рекорд
      * @note Автоматически добавляет текущую дату и сортирует список
      */
-    void addScore(const std::string& name, int score);
+    void addScore(const std::string& name, int64_t score);
     
     /**
      * @brief Отображает таблицу рекордов в консоли
@@ -146,12 +146,6 @@ public:
      */
     void resetToDefaults();
     
-    /**
-     * @brief Возвращает количество очков за дроп на указанном уровне
-     * @return Очки за клетку при быстром падении
-     */
-    static int getDropPointsForLevel(int level);
-    
     /**
      * @brief Возвращает скорость падения для указанного уровня
      * @return Скорость падения в микросекундах
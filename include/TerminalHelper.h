@@ -25,6 +25,11 @@
 class TerminalHelper {
 private:
     static bool terminalResized; /**< Флаг изменения размера терминала */
+    static int resizePipe[2];    /**< Self-pipe: обработчик SIGWINCH пишет в него байт */
+    static unsigned screenGeneration; /**< Счетчик очисток экрана */
+    static volatile bool sizeCached;  /**< false - размер нужно перечитать через ioctl() */
+    static int cachedRows;            /**< Закэшированное количество строк */
+    static int cachedCols;            /**< Закэшированное количество столбцов */
     
     /**
      * @brief Обработчик сигнала изменения размера терминала
@@ -36,6 +41,7 @@ public:
     /**
      * @brief Получает текущий размер терминала
      * @return true если размер успешно получен
+     * @note Значение кэшируется до следующего SIGWINCH
      */
     static bool getTerminalSize(int& rows, int& cols);
     
@@ -49,10 +55,17 @@ public:
     
     /**
      * @brief Очищает экран терминала
-     * @note Использует ANSI escape-последовательности
+     * @note Использует ANSI escape-последовательности и увеличивает поколение экрана
      */
     static void clearScreen();
     
+    /**
+     * @brief Возвращает поколение экрана
+     * @return Число, которое меняется при каждой очистке или смене буфера экрана
+     * @note FrameBuffer сравнивает его со своим, чтобы понять, что экран стерт
+     */
+    static unsigned getScreenGeneration();
+    
     /**
      * @brief Перемещает курсор в указанную позицию
      */
@@ -65,7 +78,7 @@ public:
     
     /**
      * @brief Инициализирует обработчик изменения размера терминала
-     * @note Устанавливает обработчик для сигнала SIGWINCH
+     * @note Устанавливает обработчик для сигнала SIGWINCH и создает self-pipe
      */
     static void initResizeHandler();
 
@@ -74,6 +87,18 @@ public:
      * @return true если размер изменился с последней проверки
      */
     static bool wasResized();
+    
+    /**
+     * @brief Возвращает дескриптор чтения self-pipe сигнала SIGWINCH
+     * @return Дескриптор или -1, если обработчик не инициализирован
+     * @note Используется EventLoop для пробуждения при изменении размера
+     */
+    static int getResizeFd();
+    
+    /**
+     * @brief Вычитывает все накопленные байты из self-pipe
+     */
+    static void drainResizeFd();
 
     /**
      * @brief Получает текущий размер терминала
@@ -0,0 +1,76 @@
+/**
+ * @file TerminalOutput.h
+ * @brief Заголовочный файл, содержащий объявление класса TerminalOutput - буфера вывода в терминал
+ */
+#ifndef TERMINALOUTPUT_H
+#define TERMINALOUTPUT_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Счетчики вывода в терминал
+ */
+struct OutputCounters {
+    uint64_t syscalls; /**< Количество вызовов write() */
+    uint64_t bytes;    /**< Количество выведенных байт */
+};
+
+/**
+ * @brief Общий буфер всего вывода в терминал
+ * 
+ * TerminalHelper и std::cout (после install()) пишут в один статический
+ * буфер, который выводится одним вызовом write() в конце кадра: перед
+ * ожиданием событий, перед чтением ввода или при явном flush().
+ * Буфер не выделяет память во время работы.
+ */
+class TerminalOutput {
+public:
+    /**
+     * @brief Перенаправляет std::cout в буфер
+     * @note std::cout.flush() и std::endl вызывают flush()
+     */
+    static void install();
+    
+    /**
+     * @brief Выводит буфер и возвращает std::cout исходный streambuf
+     */
+    static void uninstall();
+    
+    /**
+     * @brief Добавляет данные в буфер
+     * @param data Указатель на данные
+     * @param length Длина в байтах
+     * @note При переполнении буфер выводится заранее
+     */
+    static void write(const char* data, size_t length);
+    
+    /**
+     * @brief Добавляет C-строку в буфер
+     */
+    static void write(const char* text);
+    
+    /**
+     * @brief Добавляет в буфер строку, отформатированную как printf
+     */
+    static void writef(const char* format, ...);
+    
+    /**
+     * @brief Выводит накопленные данные в stdout
+     * @note Обычно один системный вызов write(); частичная запись дописывается
+     */
+    static void flush();
+    
+    /**
+     * @brief Возвращает счетчики вывода с начала работы программы
+     */
+    static OutputCounters getCounters();
+    
+    /**
+     * @brief Проверяет, нужно ли печатать статистику вывода при выходе
+     * @return true если программа собрана с TETRIS_OUTPUT_STATS
+     */
+    static bool isStatsEnabled();
+};
+
+#endif
@@ -0,0 +1,171 @@
+/**
+ * @file TetrisEngine.h
+ * @brief Заголовочный файл, содержащий объявление класса TetrisEngine - игровых правил без ввода-вывода
+ */
+#ifndef TETRISENGINE_H
+#define TETRISENGINE_H
+
+#include "Field.h"
+#include "Figure.h"
+#include "Randomizer.h"
+#include <cstdint>
+
+/**
+ * @brief Режим партии
+ */
+enum GameMode : uint8_t {
+    MODE_CLASSIC,          /**< Классический Тетрис */
+    MODE_BUCKET,           /**< Ведро */
+    MODE_PICTURE_SQUARE,   /**< Собери картинку: квадрат */
+    MODE_PICTURE_TRIANGLE, /**< Собери картинку: треугольник */
+    MODE_COUNT             /**< Количество режимов */
+};
+
+/**
+ * @brief Действие, применяемое к текущей фигуре
+ * @note Действия повторяют правила игры: движение влево и вправо
+ *       сдвигает фигуру по диагонали вниз, поворот тоже опускает фигуру
+ */
+enum EngineAction : uint8_t {
+    ACTION_LEFT,      /**< Влево и на строку вниз */
+    ACTION_RIGHT,     /**< Вправо и на строку вниз */
+    ACTION_SOFT_DROP, /**< На строку вниз с очками за ускорение */
+    ACTION_HARD_DROP, /**< Падение до опоры с очками за дроп и фиксация */
+    ACTION_ROTATE,    /**< Поворот и, если возможно, строка вниз */
+    ACTION_GRAVITY,   /**< Тик гравитации: строка вниз без очков */
+    ACTION_LOCK,      /**< Фиксация фигуры, стоящей на опоре */
+    ACTION_COUNT      /**< Количество действий */
+};
+
+/**
+ * @brief События одного шага движка
+ */
+struct StepResult {
+    bool moved;           /**< Фигура сдвинулась или повернулась */
+    bool locked;          /**< Фигура зафиксирована на поле */
+    bool levelUp;         /**< После очистки линий повысился уровень */
+    bool pictureComplete; /**< Картинка собрана (режим картинки) */
+    bool pictureBroken;   /**< Фигура вышла за границы картинки (режим картинки) */
+    bool gameOver;        /**< Партия окончена */
+    int linesCleared;     /**< Количество очищенных линий */
+    int dropDistance;     /**< Глубина быстрого падения */
+    int64_t dropPoints;   /**< Очки за быстрое падение */
+    int64_t linePoints;   /**< Очки за очищенные линии */
+    int64_t scoreDelta;   /**< Изменение счета за шаг */
+    Figure lockedFigure;  /**< Зафиксированная фигура (если locked) */
+};
+
+/**
+ * @brief Игровые правила Тетриса без терминала
+ *
+ * Хранит поле, текущую фигуру, счет, уровень и состояние генератора фигур.
+ * Не выполняет ввода-вывода и не зависит от времени: гравитацию и задержку
+ * фиксации задает вызывающий код действиями ACTION_GRAVITY и ACTION_LOCK.
+ * Генератор фигур (Randomizer) принадлежит движку, поэтому несколько
+ * движков работают независимо в разных потоках, а последовательность
+ * фигур определяется только зерном.
+ */
+class TetrisEngine {
+private:
+    Field* field;              /**< Поле текущей партии */
+    Figure figure;             /**< Текущая фигура */
+    GameMode mode;             /**< Режим партии */
+    Randomizer randomizer;     /**< Генератор фигур */
+    int64_t score;             /**< Счет (за долгую партию в симуляторе выходит за пределы int) */
+    int level;                 /**< Уровень */
+    int linesClearedTotal;     /**< Всего очищено линий */
+    int piecesLocked;          /**< Зафиксировано фигур */
+    bool gameOver;             /**< Партия окончена */
+
+public:
+    TetrisEngine();
+    ~TetrisEngine();
+
+    TetrisEngine(const TetrisEngine&) = delete;
+    TetrisEngine& operator=(const TetrisEngine&) = delete;
+
+    /**
+     * @brief Начинает новую партию
+     * @param seed Зерно генератора фигур
+     * @param gameMode Режим партии
+     * @param randomizerKind Алгоритм выдачи фигур
+     * @note Партия начинается с квадрата в точке появления
+     */
+    void reset(uint64_t seed, GameMode gameMode, RandomizerKind randomizerKind = RANDOMIZER_RANDOM);
+
+    /**
+     * @brief Применяет действие к текущей фигуре
+     * @param action Действие
+     * @return События шага; после окончания партии шаги ничего не меняют
+     */
+    StepResult step(EngineAction action);
+
+    /**
+     * @brief Опускает фигуру на несколько строк (тики гравитации)
+     * @param rows Количество тиков
+     * @return На сколько строк опустилась фигура
+     */
+    int applyGravity(int rows);
+
+    /**
+     * @brief Проверяет, стоит ли фигура на опоре
+     * @return true если фигура не может опуститься ниже
+     */
+    bool isGrounded() const;
+
+    /**
+     * @brief Проверяет, можно ли сдвинуть фигуру
+     * @param dx Смещение по X
+     * @param dy Смещение по Y
+     * @return true если фигура в новой позиции не пересекается с полем
+     */
+    bool canMove(int dx, int dy) const;
+
+    /**
+     * @brief Проверяет, можно ли повернуть фигуру
+     * @return true если повернутая фигура не пересекается с полем
+     */
+    bool canRotate() const;
+
+    Field* getField() { return field; }
+    const Field* getField() const { return field; }
+    const Figure& getFigure() const { return figure; }
+    const Randomizer& getRandomizer() const { return randomizer; }
+    GameMode getMode() const { return mode; }
+    int64_t getScore() const { return score; }
+    int getLevel() const { return level; }
+    int getLinesCleared() const { return linesClearedTotal; }
+    int getPiecesLocked() const { return piecesLocked; }
+    bool isGameOver() const { return gameOver; }
+    bool isPictureMode() const { return mode == MODE_PICTURE_SQUARE || mode == MODE_PICTURE_TRIANGLE; }
+
+    /**
+     * @brief Очки за клетку быстрого падения
+     * @param level Уровень
+     * @return Очки за одну строку падения
+     */
+    static int getDropPointsForLevel(int level);
+
+    /**
+     * @brief Очки за очистку линий
+     * @param lines Количество линий, очищенных одной фигурой
+     * @param level Уровень
+     * @return Очки с учетом уровня
+     */
+    static int getLinePointsForLevel(int lines, int level);
+
+private:
+    /**
+     * @brief Фиксирует фигуру, очищает линии и выдает следующую фигуру
+     * @param result Результат шага для заполнения
+     */
+    void lockFigure(StepResult& result);
+
+    /**
+     * @brief Ставит фигуру в точку появления
+     * @param next Новая фигура
+     */
+    void spawn(const Figure& next);
+};
+
+#endif
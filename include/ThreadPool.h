@@ -0,0 +1,93 @@
+/**
+ * @file ThreadPool.h
+ * @brief Заголовочный файл, содержащий объявление класса ThreadPool - пула потоков с перехватом задач
+ */
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Пул потоков с перехватом задач (work stealing)
+ *
+ * У каждого рабочего потока своя очередь. Поток берет задачи с конца
+ * своей очереди, а когда она пуста - забирает задачи с начала очередей
+ * других потоков. Так длинные партии на одном ядре не оставляют
+ * остальные ядра без работы.
+ */
+class ThreadPool {
+private:
+    /**
+     * @brief Очередь задач одного рабочего потока
+     */
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::thread> workers;   /**< Рабочие потоки */
+    std::vector<WorkQueue*> queues;     /**< Очереди задач (по одной на поток) */
+    std::mutex stateMutex;              /**< Защищает ожидание задач и завершения */
+    std::condition_variable taskReady;  /**< Появилась задача или пул останавливается */
+    std::condition_variable allDone;    /**< Выполнены все поставленные задачи */
+    std::atomic<size_t> pending;        /**< Поставлено, но еще не выполнено задач */
+    std::atomic<size_t> nextQueue;      /**< Очередь для следующей задачи (по кругу) */
+    bool stopping;                      /**< Пул уничтожается */
+
+public:
+    /**
+     * @brief Создает пул
+     * @param threadCount Количество потоков (0 - по числу ядер)
+     */
+    explicit ThreadPool(unsigned threadCount = 0);
+
+    /**
+     * @brief Дожидается всех задач и останавливает потоки
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Ставит задачу в очередь
+     * @param task Задача
+     * @note Задачи распределяются по очередям потоков по кругу
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Ждет завершения всех поставленных задач
+     * @note Нельзя вызывать из задачи этого же пула
+     */
+    void wait();
+
+    /**
+     * @brief Возвращает количество рабочих потоков
+     */
+    unsigned size() const { return static_cast<unsigned>(workers.size()); }
+
+private:
+    /**
+     * @brief Цикл рабочего потока
+     * @param index Номер потока (и его очереди)
+     */
+    void workerLoop(unsigned index);
+
+    /**
+     * @brief Берет задачу: сначала из своей очереди, затем у других потоков
+     * @param index Номер потока
+     * @param task Выходной параметр для задачи
+     * @return true если задача найдена
+     */
+    bool takeTask(unsigned index, std::function<void()>& task);
+};
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file tetris_batch.h
+ * @brief C-интерфейс библиотеки tetris_batch: пакет партий (BatchEnv) для внешних программ обучения
+ *
+ * Библиотека собирается как разделяемая (libtetris_batch.so) и загружается,
+ * например, через ctypes или cffi. Все массивы, которые возвращают функции,
+ * принадлежат пакету и действительны до его уничтожения; значения в них
+ * обновляются каждым tetris_batch_step и tetris_batch_reset.
+ *
+ * Пример (Python):
+ * @code{.py}
+ * lib = ctypes.CDLL("./libtetris_batch.so")
+ * batch = lib.tetris_batch_create(1024, TETRIS_BATCH_MODE_CLASSIC, TETRIS_BATCH_RANDOMIZER_BAG, 0)
+ * lib.tetris_batch_reset(batch, 1)
+ * lib.tetris_batch_step(batch, actions)   # uint8[1024]
+ * @endcode
+ */
+#ifndef TETRIS_BATCH_H
+#define TETRIS_BATCH_H
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define TETRIS_BATCH_API __declspec(dllexport)
+#else
+#define TETRIS_BATCH_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Режимы (совпадают с GameMode) */
+#define TETRIS_BATCH_MODE_CLASSIC 0
+#define TETRIS_BATCH_MODE_BUCKET 1
+
+/** Алгоритмы выдачи фигур (совпадают с RandomizerKind) */
+#define TETRIS_BATCH_RANDOMIZER_RANDOM 0
+#define TETRIS_BATCH_RANDOMIZER_BAG 1
+#define TETRIS_BATCH_RANDOMIZER_HISTORY 2
+
+/** Действия (совпадают с EngineAction) */
+#define TETRIS_BATCH_ACTION_LEFT 0
+#define TETRIS_BATCH_ACTION_RIGHT 1
+#define TETRIS_BATCH_ACTION_SOFT_DROP 2
+#define TETRIS_BATCH_ACTION_HARD_DROP 3
+#define TETRIS_BATCH_ACTION_ROTATE 4
+#define TETRIS_BATCH_ACTION_GRAVITY 5
+#define TETRIS_BATCH_ACTION_LOCK 6
+
+/** Признаки поля (порядок BoardFeatures): индекс внутри записи партии */
+#define TETRIS_BATCH_FEATURE_AGGREGATE_HEIGHT 0
+#define TETRIS_BATCH_FEATURE_HOLES 1
+#define TETRIS_BATCH_FEATURE_BUMPINESS 2
+#define TETRIS_BATCH_FEATURE_LINES_CLEARED 3
+#define TETRIS_BATCH_FEATURE_WELLS 4
+#define TETRIS_BATCH_FEATURE_ROW_TRANSITIONS 5
+#define TETRIS_BATCH_FEATURE_COLUMN_TRANSITIONS 6
+#define TETRIS_BATCH_FEATURE_COUNT 7
+
+/** Флаги tetris_batch_create */
+#define TETRIS_BATCH_FLAG_NO_SIMD 1  /**< Не использовать AVX2 даже при поддержке процессором */
+
+typedef struct TetrisBatch TetrisBatch;
+
+/**
+ * @brief Создает пакет
+ * @param count Количество партий (больше 0)
+ * @param mode TETRIS_BATCH_MODE_*
+ * @param randomizer TETRIS_BATCH_RANDOMIZER_*
+ * @param flags TETRIS_BATCH_FLAG_*
+ * @return Пакет или NULL при неверных параметрах
+ */
+TETRIS_BATCH_API TetrisBatch* tetris_batch_create(int count, int mode, int randomizer, int flags);
+
+TETRIS_BATCH_API void tetris_batch_destroy(TetrisBatch* batch);
+
+/**
+ * @brief Начинает новые партии; партия i получает зерно seed + i
+ */
+TETRIS_BATCH_API void tetris_batch_reset(TetrisBatch* batch, uint64_t seed);
+
+/**
+ * @brief Начинает новую партию в одном поле (например, после окончания партии)
+ */
+TETRIS_BATCH_API void tetris_batch_reset_board(TetrisBatch* batch, int board, uint64_t seed);
+
+/**
+ * @brief Делает шаг во всех партиях
+ * @param actions Массив из count действий TETRIS_BATCH_ACTION_*
+ */
+TETRIS_BATCH_API void tetris_batch_step(TetrisBatch* batch, const uint8_t* actions);
+
+TETRIS_BATCH_API int tetris_batch_count(const TetrisBatch* batch);
+TETRIS_BATCH_API int tetris_batch_board_width(void);
+TETRIS_BATCH_API int tetris_batch_board_height(void);
+TETRIS_BATCH_API int tetris_batch_uses_simd(const TetrisBatch* batch);
+
+/**
+ * @brief Строки полей: height * count слов, слово строки row партии board - [row * count + board]
+ * @note Бит j слова - столбец j; стенки и дно входят в слова
+ */
+TETRIS_BATCH_API const uint64_t* tetris_batch_rows(const TetrisBatch* batch);
+
+TETRIS_BATCH_API const uint8_t* tetris_batch_piece_types(const TetrisBatch* batch);
+TETRIS_BATCH_API const uint8_t* tetris_batch_rotations(const TetrisBatch* batch);
+TETRIS_BATCH_API const int16_t* tetris_batch_piece_x(const TetrisBatch* batch);
+TETRIS_BATCH_API const int16_t* tetris_batch_piece_y(const TetrisBatch* batch);
+TETRIS_BATCH_API const int64_t* tetris_batch_scores(const TetrisBatch* batch);
+TETRIS_BATCH_API const int32_t* tetris_batch_levels(const TetrisBatch* batch);
+TETRIS_BATCH_API const int32_t* tetris_batch_lines(const TetrisBatch* batch);
+TETRIS_BATCH_API const uint8_t* tetris_batch_game_over(const TetrisBatch* batch);
+
+/** Итоги последнего шага */
+TETRIS_BATCH_API const int32_t* tetris_batch_rewards(const TetrisBatch* batch);
+TETRIS_BATCH_API const uint8_t* tetris_batch_lines_cleared(const TetrisBatch* batch);
+TETRIS_BATCH_API const uint8_t* tetris_batch_locked(const TetrisBatch* batch);
+
+/**
+ * @brief Считает признаки всех полей
+ * @return count * TETRIS_BATCH_FEATURE_COUNT значений: признак k партии board -
+ *         [board * TETRIS_BATCH_FEATURE_COUNT + k]; LINES_CLEARED - линии последнего шага
+ * @note Массив обновляется только этим вызовом
+ */
+TETRIS_BATCH_API const int32_t* tetris_batch_features(TetrisBatch* batch);
+
+/**
+ * @brief Фигура из очереди предпросмотра партии
+ * @param index 0 - следующая фигура (до 5)
+ * @return Тип фигуры (0 - O, 1 - L, 2 - T, 3 - I, 4 - S, 5 - Z, 6 - J) или -1
+ */
+TETRIS_BATCH_API int tetris_batch_next_piece(const TetrisBatch* batch, int board, int index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
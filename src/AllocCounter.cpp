@@ -0,0 +1,54 @@
+/**
+ * @file AllocCounter.cpp
+ * @brief Реализация отладочного счетчика выделений памяти
+ * 
+ * Замена глобальных operator new/delete подключается только при сборке
+ * с TETRIS_COUNT_ALLOCATIONS, чтобы обычная сборка не платила за подсчет.
+ */
+#include "AllocCounter.h"
+
+#ifdef TETRIS_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<uint64_t> allocationCount(0);
+
+void* countedAlloc(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+}
+
+void* operator new(std::size_t size) {
+    void* ptr = countedAlloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    void* ptr = countedAlloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+bool AllocCounter::isEnabled() { return true; }
+uint64_t AllocCounter::getCount() { return allocationCount.load(std::memory_order_relaxed); }
+#else
+bool AllocCounter::isEnabled() { return false; }
+uint64_t AllocCounter::getCount() { return 0; }
+#endif
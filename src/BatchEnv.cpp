@@ -0,0 +1,580 @@
+/**
+ * @file BatchEnv.cpp
+ * @brief Реализация пакета партий со структурой массивов и ядрами AVX2
+ */
+#include "BatchEnv.h"
+#include "CpuFeatures.h"
+#include <algorithm>
+#include <cstring>
+
+#if TETRIS_HAVE_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Маски строк всех фигур в 64-битных словах (для выборки gather)
+ * @note Индекс - (тип * 4 + поворот) * 4 + строка
+ */
+struct PieceMaskTable {
+    int64_t masks[PIECE_COUNT * 16];
+    int8_t lowest[PIECE_COUNT * 16];  /**< Нижняя клетка столбца рамки (-1 - столбец пуст) */
+
+    PieceMaskTable() {
+        for (int type = 0; type < PIECE_COUNT; type++) {
+            for (int rot = 0; rot < 4; rot++) {
+                const PieceShape& shape = Figure::getShape(static_cast<PieceType>(type), rot);
+                int index = (type * 4 + rot) * 4;
+                for (int i = 0; i < 4; i++) {
+                    masks[index + i] = (i < shape.size) ? shape.rows[i] : 0;
+                    lowest[index + i] = -1;
+                }
+                for (int i = 0; i < shape.size; i++) {
+                    for (int j = 0; j < 4; j++) {
+                        if ((shape.rows[i] >> j) & 1) {
+                            lowest[index + j] = static_cast<int8_t>(i);
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+const PieceMaskTable PIECE_MASKS;
+
+/**
+ * @brief Аргументы ядер: положение фигуры каждой партии и выход
+ */
+struct KernelArgs {
+    const BoardRow* rows;     /**< Строки всех полей */
+    int count;                /**< Количество партий */
+    const uint8_t* type;      /**< Тип фигуры */
+    const uint8_t* rotation;  /**< Поворот */
+    const int16_t* x;         /**< X рамки */
+    const int16_t* y;         /**< Y рамки */
+    const uint8_t* active;    /**< Партии, которые нужно проверить */
+    uint8_t* out;             /**< Результат по партиям */
+};
+
+typedef void (*Kernel)(const KernelArgs& args, int first);
+
+/**
+ * @brief Столкновение фигуры партии b в положении (rotation, x, y), как Field::collides
+ */
+inline bool collidesAt(const KernelArgs& args, int b, int y) {
+    const int64_t* shape = PIECE_MASKS.masks + (args.type[b] * 4 + args.rotation[b]) * 4;
+    int x = args.x[b];
+    BoardRow hit = 0;
+    for (int i = 0; i < 4; i++) {
+        BoardRow mask = static_cast<BoardRow>(shape[i]);
+        if (!mask) continue;
+        if (x < 0) {
+            hit |= mask & ((BoardRow(1) << -x) - 1);
+            mask >>= -x;
+        } else {
+            mask <<= x;
+        }
+        int row = y + i;
+        BoardRow bits = (row >= 0 && row < BOARD_HEIGHT) ? args.rows[row * args.count + b] : ~BoardRow(0);
+        hit |= bits & mask;
+    }
+    return hit != 0;
+}
+
+/**
+ * @brief Столкновения фигур с полем
+ * @note out[b] = 1, если клетка фигуры занята или вне поля
+ */
+void collidePortable(const KernelArgs& args, int first) {
+    for (int b = first; b < args.count; b++) {
+        if (args.active[b]) {
+            args.out[b] = collidesAt(args, b, args.y[b]);
+        }
+    }
+}
+
+/**
+ * @brief Заполненные строки под рамкой фигуры
+ * @note out[b] - бит i установлен, если строка y + i (от 1 до дна не включая)
+ *       заполнена целиком; те же строки проверяет Field::clearFullLines
+ */
+void fullRowsPortable(const KernelArgs& args, int first) {
+    for (int b = first; b < args.count; b++) {
+        if (!args.active[b]) continue;
+        uint8_t full = 0;
+        for (int i = 0; i < 4; i++) {
+            int row = args.y[b] + i;
+            if (row >= 1 && row <= BOARD_HEIGHT - 2 && args.rows[row * args.count + b] == ~BoardRow(0)) {
+                full |= static_cast<uint8_t>(1 << i);
+            }
+        }
+        args.out[b] = full;
+    }
+}
+
+#if TETRIS_HAVE_AVX2_KERNELS
+
+/**
+ * @brief Загружает четыре байта партий в 64-битные дорожки
+ */
+TETRIS_TARGET_AVX2 inline __m256i loadBytes(const uint8_t* values) {
+    int32_t packed;
+    std::memcpy(&packed, values, sizeof(packed));
+    return _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(packed));
+}
+
+/**
+ * @brief Загружает четыре int16 партий в 64-битные дорожки
+ */
+TETRIS_TARGET_AVX2 inline __m256i loadShorts(const int16_t* values) {
+    return _mm256_cvtepi16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(values)));
+}
+
+/**
+ * @brief Проверяет, есть ли среди четырех партий активные
+ */
+inline bool anyActive(const uint8_t* active) {
+    int32_t packed;
+    std::memcpy(&packed, active, sizeof(packed));
+    return packed != 0;
+}
+
+/**
+ * @brief Маски строк фигур четырех партий, сдвинутые на их X
+ */
+struct LaneShapes {
+    __m256i rows[4];  /**< Сдвинутые маски строк рамки */
+    __m256i lost;     /**< Клетки левее нулевого столбца (столкновение) */
+    __m256i board;    /**< Номера партий дорожек */
+};
+
+/**
+ * @brief Готовит маски фигур партий first..first+3
+ * @algorithm
+ * Маски строк выбираются из таблицы gather по (тип, поворот, строка)
+ * каждой дорожки и сдвигаются на X дорожки (sllv/srlv)
+ */
+TETRIS_TARGET_AVX2 inline void loadShapes(const KernelArgs& args, int first, LaneShapes& shapes) {
+    const long long* masks = reinterpret_cast<const long long*>(PIECE_MASKS.masks);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi64x(1);
+    __m256i shapeIndex = _mm256_slli_epi64(
+        _mm256_add_epi64(_mm256_slli_epi64(loadBytes(args.type + first), 2), loadBytes(args.rotation + first)), 2);
+    __m256i x = loadShorts(args.x + first);
+    __m256i negative = _mm256_cmpgt_epi64(zero, x);
+    __m256i shiftRight = _mm256_and_si256(negative, _mm256_sub_epi64(zero, x));
+    __m256i shiftLeft = _mm256_andnot_si256(negative, x);
+    __m256i cutOff = _mm256_sub_epi64(_mm256_sllv_epi64(one, shiftRight), one);
+    shapes.lost = zero;
+    for (int i = 0; i < 4; i++) {
+        __m256i mask = _mm256_i64gather_epi64(masks, _mm256_add_epi64(shapeIndex, _mm256_set1_epi64x(i)), 8);
+        shapes.lost = _mm256_or_si256(shapes.lost, _mm256_and_si256(mask, cutOff));
+        shapes.rows[i] = _mm256_sllv_epi64(_mm256_srlv_epi64(mask, shiftRight), shiftLeft);
+    }
+    shapes.board = _mm256_add_epi64(_mm256_set1_epi64x(first), _mm256_setr_epi64x(0, 1, 2, 3));
+}
+
+/**
+ * @brief Пересечение фигур четырех партий с полями при Y дорожек y
+ * @note Слова строк выбираются gather по индексу row * count + board
+ *       с маской: строки вне поля не читаются и считаются занятыми
+ */
+TETRIS_TARGET_AVX2 inline __m256i overlapAt(const KernelArgs& args, const LaneShapes& shapes, __m256i y) {
+    const long long* rows = reinterpret_cast<const long long*>(args.rows);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i allOnes = _mm256_set1_epi64x(-1);
+    const __m256i height = _mm256_set1_epi64x(BOARD_HEIGHT);
+    const __m256i stride = _mm256_set1_epi64x(args.count);
+    __m256i hit = shapes.lost;
+    for (int i = 0; i < 4; i++) {
+        __m256i row = _mm256_add_epi64(y, _mm256_set1_epi64x(i));
+        __m256i inside = _mm256_andnot_si256(_mm256_cmpgt_epi64(zero, row), _mm256_cmpgt_epi64(height, row));
+        __m256i index = _mm256_add_epi64(_mm256_mul_epu32(row, stride), shapes.board);
+        __m256i bits = _mm256_mask_i64gather_epi64(allOnes, rows, index, inside, 8);
+        hit = _mm256_or_si256(hit, _mm256_and_si256(bits, shapes.rows[i]));
+    }
+    return hit;
+}
+
+/**
+ * @brief collidePortable по четыре партии
+ */
+TETRIS_TARGET_AVX2 void collideAvx2(const KernelArgs& args, int first) {
+    const __m256i zero = _mm256_setzero_si256();
+    int b = first;
+    for (; b + 4 <= args.count; b += 4) {
+        if (!anyActive(args.active + b)) continue;
+        LaneShapes shapes;
+        loadShapes(args, b, shapes);
+        __m256i hit = overlapAt(args, shapes, loadShorts(args.y + b));
+        int clear = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(hit, zero)));
+        for (int k = 0; k < 4; k++) {
+            args.out[b + k] = !((clear >> k) & 1);
+        }
+    }
+    collidePortable(args, b);
+}
+
+/**
+ * @brief fullRowsPortable по четыре партии
+ */
+TETRIS_TARGET_AVX2 void fullRowsAvx2(const KernelArgs& args, int first) {
+    const long long* rows = reinterpret_cast<const long long*>(args.rows);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i allOnes = _mm256_set1_epi64x(-1);
+    const __m256i lastRow = _mm256_set1_epi64x(BOARD_HEIGHT - 1);
+    const __m256i stride = _mm256_set1_epi64x(args.count);
+    const __m256i lanes = _mm256_setr_epi64x(0, 1, 2, 3);
+
+    int b = first;
+    for (; b + 4 <= args.count; b += 4) {
+        if (!anyActive(args.active + b)) continue;
+        __m256i y = loadShorts(args.y + b);
+        __m256i board = _mm256_add_epi64(_mm256_set1_epi64x(b), lanes);
+        int full[4] = {0, 0, 0, 0};
+        for (int i = 0; i < 4; i++) {
+            __m256i row = _mm256_add_epi64(y, _mm256_set1_epi64x(i));
+            __m256i inside = _mm256_and_si256(_mm256_cmpgt_epi64(row, zero), _mm256_cmpgt_epi64(lastRow, row));
+            __m256i index = _mm256_add_epi64(_mm256_mul_epu32(row, stride), board);
+            __m256i bits = _mm256_mask_i64gather_epi64(zero, rows, index, inside, 8);
+            int lanesFull = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(bits, allOnes)));
+            for (int k = 0; k < 4; k++) {
+                full[k] |= ((lanesFull >> k) & 1) << i;
+            }
+        }
+        for (int k = 0; k < 4; k++) {
+            args.out[b + k] = static_cast<uint8_t>(full[k]);
+        }
+    }
+    fullRowsPortable(args, b);
+}
+
+#endif
+
+/**
+ * @brief Поворот, как Figure::rotate: O не вращается
+ */
+uint8_t rotated(uint8_t type, uint8_t rotation) {
+    return (type == PIECE_O) ? 0 : static_cast<uint8_t>((rotation + 1) & 3);
+}
+
+}
+
+BatchEnv::BatchEnv(int boardCount, GameMode gameMode, RandomizerKind kind, bool allowSimd) :
+    count(std::max(1, boardCount)),
+    mode(gameMode == MODE_BUCKET ? MODE_BUCKET : MODE_CLASSIC),
+    randomizerKind(kind),
+    simd(allowSimd && cpuHasAvx2()),
+    featureShape(mode == MODE_BUCKET ? FeatureShape(BucketField()) : FeatureShape(Field())),
+    rows(static_cast<size_t>(count) * BOARD_HEIGHT),
+    columns(static_cast<size_t>(count) * BOARD_WIDTH),
+    pieceType(count),
+    rotation(count),
+    pieceX(count),
+    pieceY(count),
+    score(count),
+    level(count),
+    lines(count),
+    piecesLocked(count),
+    gameOver(count),
+    randomizers(count),
+    reward(count),
+    linesCleared(count),
+    locked(count),
+    features(count),
+    candidateRotation(count),
+    candidateX(count),
+    candidateY(count),
+    active(count),
+    blocked(count),
+    fullRows(count),
+    dropDistance(count)
+{
+    if (mode == MODE_BUCKET) {
+        BucketField field;
+        for (int row = 0; row < BOARD_HEIGHT; row++) {
+            wallRows[row] = field.getRowBits(row);
+        }
+    } else {
+        Field field;
+        for (int row = 0; row < BOARD_HEIGHT; row++) {
+            wallRows[row] = field.getRowBits(row);
+        }
+    }
+    for (int col = 0; col < BOARD_WIDTH; col++) {
+        wallColumns[col] = ~BoardRow(0) << BOARD_HEIGHT;
+        for (int row = 0; row < BOARD_HEIGHT; row++) {
+            wallColumns[col] |= ((wallRows[row] >> col) & 1) << row;
+        }
+    }
+    reset(0);
+}
+
+void BatchEnv::reset(uint64_t seed) {
+    for (int b = 0; b < count; b++) {
+        resetBoard(b, seed + static_cast<uint64_t>(b));
+    }
+}
+
+void BatchEnv::resetBoard(int board, uint64_t seed) {
+    for (int row = 0; row < BOARD_HEIGHT; row++) {
+        rows[row * count + board] = wallRows[row];
+    }
+    for (int col = 0; col < BOARD_WIDTH; col++) {
+        columns[col * count + board] = wallColumns[col];
+    }
+    randomizers[board].reset(seed, randomizerKind);
+    score[board] = 0;
+    level[board] = 1;
+    lines[board] = 0;
+    piecesLocked[board] = 0;
+    gameOver[board] = 0;
+    reward[board] = 0;
+    linesCleared[board] = 0;
+    locked[board] = 0;
+    /** Как TetrisEngine::reset: партия начинается с квадрата */
+    spawn(board, PIECE_O);
+}
+
+void BatchEnv::spawn(int board, PieceType type) {
+    pieceType[board] = type;
+    rotation[board] = 0;
+    pieceX[board] = SPAWN_X;
+    pieceY[board] = SPAWN_Y;
+}
+
+void BatchEnv::testCandidates() {
+    KernelArgs args = { rows.data(), count, pieceType.data(), candidateRotation.data(),
+                        candidateX.data(), candidateY.data(), active.data(), blocked.data() };
+#if TETRIS_HAVE_AVX2_KERNELS
+    if (simd) {
+        collideAvx2(args, 0);
+        return;
+    }
+#endif
+    collidePortable(args, 0);
+}
+
+void BatchEnv::measureDrops() {
+    /**
+     * @algorithm
+     * Для каждого столбца рамки с нижней клеткой в строке r свободных
+     * строк под ней - число нулевых младших бит слова столбца, сдвинутого
+     * на r + 1 (строки ниже поля в слове заняты). Глубина дропа - минимум
+     * по столбцам фигуры; проход по строкам не нужен
+     */
+    for (int b = 0; b < count; b++) {
+        if (!active[b]) continue;
+        const int8_t* lowest = PIECE_MASKS.lowest + (pieceType[b] * 4 + rotation[b]) * 4;
+        int depth = BOARD_HEIGHT;
+        for (int j = 0; j < 4; j++) {
+            if (lowest[j] < 0) continue;
+            BoardRow column = columns[(pieceX[b] + j) * count + b];
+            int below = __builtin_ctzll(column >> (pieceY[b] + lowest[j] + 1));
+            depth = std::min(depth, below);
+        }
+        dropDistance[b] = depth;
+    }
+}
+
+void BatchEnv::rebuildColumns(int board) {
+    for (int col = 0; col < BOARD_WIDTH; col++) {
+        BoardRow column = ~BoardRow(0) << BOARD_HEIGHT;
+        for (int row = 0; row < BOARD_HEIGHT; row++) {
+            column |= ((rows[row * count + board] >> col) & 1) << row;
+        }
+        columns[col * count + board] = column;
+    }
+}
+
+const BoardFeatures* BatchEnv::computeFeatures() {
+    extractFeatures(rows.data(), count, featureShape, features.data(), simd);
+    for (int b = 0; b < count; b++) {
+        features[b].linesCleared = linesCleared[b];
+    }
+    return features.data();
+}
+
+void BatchEnv::step(const uint8_t* actions) {
+    /**
+     * @algorithm
+     * 1. Для каждой партии строится положение, которое проверяет ее
+     *    действие (сдвиг, поворот или строка вниз), и все положения
+     *    проверяются одним вызовом ядра
+     * 2. Удавшийся поворот проверяет строку вниз вторым вызовом
+     * 3. Глубина дропа считается по словам столбцов (measureDrops)
+     * 4. Фигуры после дропа и ACTION_LOCK на опоре фиксируются (lockActive)
+     */
+    bool anyRotated = false;
+    bool anyDropped = false;
+    for (int b = 0; b < count; b++) {
+        reward[b] = 0;
+        linesCleared[b] = 0;
+        locked[b] = 0;
+        dropDistance[b] = 0;
+        uint8_t action = actions[b];
+        active[b] = !gameOver[b] && action < ACTION_COUNT && action != ACTION_HARD_DROP;
+        candidateRotation[b] = rotation[b];
+        candidateX[b] = pieceX[b];
+        candidateY[b] = static_cast<int16_t>(pieceY[b] + 1);
+        if (action == ACTION_LEFT) {
+            candidateX[b]--;
+        } else if (action == ACTION_RIGHT) {
+            candidateX[b]++;
+        } else if (action == ACTION_ROTATE) {
+            candidateRotation[b] = rotated(pieceType[b], rotation[b]);
+            candidateY[b] = pieceY[b];
+        } else if (action == ACTION_HARD_DROP && !gameOver[b]) {
+            anyDropped = true;
+        }
+    }
+    testCandidates();
+
+    for (int b = 0; b < count; b++) {
+        if (!active[b]) continue;
+        bool free = !blocked[b];
+        active[b] = 0;
+        switch (actions[b]) {
+            case ACTION_LEFT:
+            case ACTION_RIGHT:
+            case ACTION_SOFT_DROP:
+            case ACTION_GRAVITY:
+                if (free) {
+                    pieceX[b] = candidateX[b];
+                    pieceY[b] = candidateY[b];
+                    if (actions[b] == ACTION_SOFT_DROP) {
+                        reward[b] += 40 * level[b];
+                    }
+                }
+                break;
+            case ACTION_ROTATE:
+                if (free) {
+                    rotation[b] = candidateRotation[b];
+                    candidateY[b] = static_cast<int16_t>(pieceY[b] + 1);
+                    active[b] = 1;
+                    anyRotated = true;
+                }
+                break;
+            case ACTION_LOCK:
+                locked[b] = !free;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (anyRotated) {
+        testCandidates();
+        for (int b = 0; b < count; b++) {
+            if (active[b] && !blocked[b]) {
+                pieceY[b]++;
+            }
+        }
+    }
+
+    if (anyDropped) {
+        for (int b = 0; b < count; b++) {
+            active[b] = !gameOver[b] && actions[b] == ACTION_HARD_DROP;
+        }
+        measureDrops();
+        for (int b = 0; b < count; b++) {
+            if (active[b]) {
+                pieceY[b] = static_cast<int16_t>(pieceY[b] + dropDistance[b]);
+                reward[b] += TetrisEngine::getDropPointsForLevel(level[b]) * dropDistance[b];
+                locked[b] = 1;
+            }
+        }
+    }
+
+    bool anyLocked = false;
+    for (int b = 0; b < count; b++) {
+        active[b] = locked[b];
+        anyLocked = anyLocked || locked[b];
+    }
+    if (anyLocked) {
+        lockActive();
+    }
+    for (int b = 0; b < count; b++) {
+        score[b] += reward[b];
+    }
+}
+
+void BatchEnv::lockActive() {
+    for (int b = 0; b < count; b++) {
+        if (!active[b]) continue;
+        const int64_t* shape = PIECE_MASKS.masks + (pieceType[b] * 4 + rotation[b]) * 4;
+        int x = pieceX[b];
+        for (int i = 0; i < 4; i++) {
+            BoardRow mask = static_cast<BoardRow>(shape[i]);
+            if (!mask) continue;
+            mask = (x < 0) ? (mask >> -x) : (mask << x);
+            int row = pieceY[b] + i;
+            rows[row * count + b] |= mask;
+            for (; mask; mask &= mask - 1) {
+                columns[__builtin_ctzll(mask) * count + b] |= BoardRow(1) << row;
+            }
+        }
+        piecesLocked[b]++;
+    }
+
+    KernelArgs args = { rows.data(), count, pieceType.data(), rotation.data(),
+                        pieceX.data(), pieceY.data(), active.data(), fullRows.data() };
+#if TETRIS_HAVE_AVX2_KERNELS
+    if (simd) {
+        fullRowsAvx2(args, 0);
+    } else
+#endif
+    {
+        fullRowsPortable(args, 0);
+    }
+
+    for (int b = 0; b < count; b++) {
+        if (!active[b]) continue;
+        if (fullRows[b]) {
+            int lowest = pieceY[b] + 31 - __builtin_clz(fullRows[b]);
+            int removed = compactRows(b, lowest);
+            rebuildColumns(b);
+            linesCleared[b] = static_cast<uint8_t>(removed);
+            lines[b] += removed;
+            reward[b] += TetrisEngine::getLinePointsForLevel(removed, level[b]);
+            if (lines[b] >= level[b] * 10) {
+                level[b]++;
+            }
+        }
+        spawn(b, randomizers[b].next());
+        candidateRotation[b] = rotation[b];
+        candidateX[b] = pieceX[b];
+        candidateY[b] = pieceY[b];
+    }
+
+    /** Новой фигуре нет места - партия окончена */
+    testCandidates();
+    for (int b = 0; b < count; b++) {
+        if (active[b] && blocked[b]) {
+            gameOver[b] = 1;
+        }
+    }
+}
+
+int BatchEnv::compactRows(int board, int lastRow) {
+    BoardRow* boardRows = rows.data() + board;
+    const size_t stride = static_cast<size_t>(count);
+    int write = lastRow;
+    for (int read = lastRow; read >= 0; read--) {
+        BoardRow stack = boardRows[read * stride] & ~wallRows[read];
+        if (write >= 1 && (wallRows[write] | stack) == ~BoardRow(0)) {
+            continue;
+        }
+        if (write != read) {
+            boardRows[write * stride] = wallRows[write] | (stack & ~wallRows[write]);
+        }
+        write--;
+    }
+    int removed = write + 1;
+    for (int row = write; row >= 0; row--) {
+        boardRows[row * stride] = wallRows[row];
+    }
+    return removed;
+}
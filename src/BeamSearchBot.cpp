@@ -0,0 +1,267 @@
+/**
+ * @file BeamSearchBot.cpp
+ * @brief Реализация лучевого поиска по очереди предпросмотра
+ */
+#include "BeamSearchBot.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace {
+
+int64_t steadyMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Проверяет, что две фигуры занимают одни и те же клетки
+ * @note Разные состояния поворота S, Z и I могут давать одинаковые клетки
+ */
+bool sameCells(const Figure& a, const Figure& b) {
+    if (a.getType() != b.getType()) {
+        return false;
+    }
+    int cellsA[4];
+    int cellsB[4];
+    int countA = 0;
+    int countB = 0;
+    for (int i = 0; i < 4; i++) {
+        for (unsigned mask = a.getRowMask(i); mask && countA < 4; mask &= mask - 1) {
+            cellsA[countA++] = (a.getstarty() + i) * 64 + a.getstartx() + __builtin_ctz(mask);
+        }
+        for (unsigned mask = b.getRowMask(i); mask && countB < 4; mask &= mask - 1) {
+            cellsB[countB++] = (b.getstarty() + i) * 64 + b.getstartx() + __builtin_ctz(mask);
+        }
+    }
+    return countA == countB && std::equal(cellsA, cellsA + countA, cellsB);
+}
+
+}
+
+BeamSearchBot::BeamSearchBot(const BeamSearchOptions& searchOptions, const BotWeights& weights) :
+    options(searchOptions),
+    pool(nullptr),
+    evaluators(),
+    slotCandidates(),
+    candidates(),
+    timedOut(false),
+    deadline(0),
+    follower(),
+    path(),
+    target(),
+    targetPiece(-1),
+    lastDepth(0)
+{
+    if (options.threads != 1) {
+        pool = new ThreadPool(options.threads);
+    }
+    unsigned slots = pool ? pool->size() : 1;
+    evaluators.assign(slots, HeuristicBot(weights));
+    slotCandidates.resize(slots);
+    setSearchLimits(options.depth, options.width, options.budgetMicros);
+}
+
+BeamSearchBot::~BeamSearchBot() {
+    delete pool;
+}
+
+void BeamSearchBot::setSearchLimits(int depth, int width, int64_t budgetMicros) {
+    options.depth = std::max(1, std::min(depth, Randomizer::PREVIEW_SIZE + 1));
+    options.width = std::max(1, std::min(width, 4096));
+    options.budgetMicros = std::max<int64_t>(0, budgetMicros);
+    /** Буферы растут только при увеличении ширины, поиск их не выделяет */
+    size_t perNode = MoveGenerator::ROTATIONS * BOARD_WIDTH * 2;
+    for (int i = 0; i < 2; i++) {
+        if (boards[i].size() < static_cast<size_t>(options.width)) {
+            boards[i].resize(options.width);
+        }
+        nodes[i].reserve(options.width);
+    }
+    candidates.reserve(options.width * perNode);
+    for (size_t slot = 0; slot < slotCandidates.size(); slot++) {
+        slotCandidates[slot].reserve(options.width * perNode / slotCandidates.size() + perNode);
+    }
+    targetPiece = -1;
+}
+
+bool BeamSearchBot::isOverBudget() {
+    if (options.budgetMicros > 0 && steadyMicros() > deadline) {
+        timedOut.store(true);
+    }
+    return timedOut.load();
+}
+
+void BeamSearchBot::expand(int slot, int level, int first, int last, const Figure& piece) {
+    HeuristicBot& evaluator = evaluators[slot];
+    std::vector<Candidate>& out = slotCandidates[slot];
+    const std::vector<Field>& fields = boards[level & 1];
+    const std::vector<BeamNode>& beam = nodes[level & 1];
+    float lineWeight = evaluator.getWeights().linesCleared;
+    out.clear();
+    for (int node = first; node < last; node++) {
+        if (isOverBudget()) {
+            return;
+        }
+        /** Фигуре некуда встать - узел проигран и потомков не имеет */
+        int count = evaluator.evaluatePlacements(fields[node], piece);
+        const std::vector<Placement>& placements = evaluator.getPlacements();
+        const std::vector<BoardFeatures>& features = evaluator.getPlacementFeatures();
+        const std::vector<float>& scores = evaluator.getPlacementScores();
+        for (int i = 0; i < count; i++) {
+            Candidate candidate;
+            candidate.value = beam[node].lineScore + scores[i];
+            candidate.lineScore = beam[node].lineScore + lineWeight * features[i].linesCleared;
+            candidate.parent = static_cast<int16_t>(node);
+            candidate.order = static_cast<int16_t>(i);
+            candidate.root = beam[node].root;
+            candidate.figure = placements[i].figure;
+            out.push_back(candidate);
+        }
+    }
+}
+
+void BeamSearchBot::select(const Field& rootField, int level) {
+    size_t keep = std::min(candidates.size(), static_cast<size_t>(options.width));
+    /** Сравнение с учетом порядка делает отбор независимым от реализации сортировки */
+    std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(),
+                      [](const Candidate& a, const Candidate& b) {
+                          if (a.value != b.value) return a.value > b.value;
+                          if (a.parent != b.parent) return a.parent < b.parent;
+                          return a.order < b.order;
+                      });
+    std::vector<Field>& fields = boards[level & 1];
+    const std::vector<Field>& parents = boards[(level + 1) & 1];
+    std::vector<BeamNode>& beam = nodes[level & 1];
+    beam.clear();
+    for (size_t i = 0; i < keep; i++) {
+        const Candidate& candidate = candidates[i];
+        fields[i] = (candidate.parent < 0) ? rootField : parents[candidate.parent];
+        Figure placed = candidate.figure;
+        fields[i].placeFigure(placed);
+        fields[i].clearFullLines();
+        BeamNode node;
+        node.value = candidate.value;
+        node.lineScore = candidate.lineScore;
+        node.root = candidate.root;
+        beam.push_back(node);
+    }
+}
+
+const std::vector<EngineAction>& BeamSearchBot::plan(const TetrisEngine& engine) {
+    /**
+     * @algorithm
+     * 1. Корень: положения текущей фигуры становятся кандидатами
+     * 2. Для каждой следующей фигуры из очереди: width лучших кандидатов
+     *    получают поля, каждое поле раскрывается положениями этой фигуры
+     * 3. Лучший кандидат последнего полного уровня определяет положение
+     *    текущей фигуры, путь к нему строит генератор ходов
+     */
+    path.clear();
+    targetPiece = -1;
+    lastDepth = 0;
+    timedOut.store(false);
+    deadline = (options.budgetMicros > 0) ? steadyMicros() + options.budgetMicros
+                                          : std::numeric_limits<int64_t>::max();
+    const Field* field = engine.getField();
+    if (!field) {
+        return path;
+    }
+    const Figure& figure = engine.getFigure();
+
+    HeuristicBot& rootEvaluator = evaluators[0];
+    int rootCount = rootEvaluator.evaluatePlacements(*field, figure);
+    if (rootCount == 0) {
+        return path;
+    }
+    float lineWeight = rootEvaluator.getWeights().linesCleared;
+    candidates.clear();
+    for (int i = 0; i < rootCount; i++) {
+        Candidate candidate;
+        candidate.value = rootEvaluator.getPlacementScores()[i];
+        candidate.lineScore = lineWeight * rootEvaluator.getPlacementFeatures()[i].linesCleared;
+        candidate.parent = -1;
+        candidate.order = static_cast<int16_t>(i);
+        candidate.root = static_cast<int16_t>(i);
+        candidate.figure = rootEvaluator.getPlacements()[i].figure;
+        candidates.push_back(candidate);
+    }
+
+    int bestRoot = 0;
+    for (size_t i = 1; i < candidates.size(); i++) {
+        if (candidates[i].value > candidates[bestRoot].value) {
+            bestRoot = static_cast<int>(i);
+        }
+    }
+    lastDepth = 1;
+
+    int depth = engine.isPictureMode() ? 1 : options.depth;
+    for (int level = 0; level + 1 < depth; level++) {
+        select(*field, level);
+        if (isOverBudget()) {
+            break;
+        }
+        Figure piece(engine.getRandomizer().peek(level));
+        piece.setPosition(SPAWN_X, SPAWN_Y);
+
+        int count = static_cast<int>(nodes[level & 1].size());
+        int slots = std::min(static_cast<int>(evaluators.size()), count);
+        if (!pool || slots <= 1) {
+            slots = 1;
+            expand(0, level, 0, count, piece);
+        } else {
+            for (int slot = 0; slot < slots; slot++) {
+                int first = count * slot / slots;
+                int last = count * (slot + 1) / slots;
+                pool->submit([this, slot, level, first, last, piece] {
+                    expand(slot, level, first, last, piece);
+                });
+            }
+            pool->wait();
+        }
+        if (timedOut.load()) {
+            break;
+        }
+
+        candidates.clear();
+        for (int slot = 0; slot < slots; slot++) {
+            candidates.insert(candidates.end(), slotCandidates[slot].begin(), slotCandidates[slot].end());
+        }
+        if (candidates.empty()) {
+            break;
+        }
+        int best = 0;
+        for (size_t i = 1; i < candidates.size(); i++) {
+            if (candidates[i].value > candidates[best].value) {
+                best = static_cast<int>(i);
+            }
+        }
+        bestRoot = candidates[best].root;
+        lastDepth = level + 2;
+    }
+
+    follower.generate(*field, figure);
+    const Placement& chosen = follower.getPlacements()[bestRoot];
+    follower.getPath(chosen, path);
+    target = chosen.figure;
+    targetPiece = engine.getPiecesLocked();
+    return path;
+}
+
+EngineAction BeamSearchBot::nextAction(const TetrisEngine& engine) {
+    if (!engine.getField()) {
+        return ACTION_HARD_DROP;
+    }
+    if (targetPiece == engine.getPiecesLocked()) {
+        int count = follower.generate(*engine.getField(), engine.getFigure());
+        const std::vector<Placement>& placements = follower.getPlacements();
+        for (int i = 0; i < count; i++) {
+            if (sameCells(placements[i].figure, target)) {
+                follower.getPath(placements[i], path);
+                return path.front();
+            }
+        }
+    }
+    const std::vector<EngineAction>& actions = plan(engine);
+    return actions.empty() ? ACTION_HARD_DROP : actions.front();
+}
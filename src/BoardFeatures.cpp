@@ -0,0 +1,262 @@
+/**
+ * @file BoardFeatures.cpp
+ * @brief Реализация подсчета признаков поля по битборду: переносимая версия, POPCNT и AVX2
+ */
+#include "BoardFeatures.h"
+#include "CpuFeatures.h"
+
+#if TETRIS_HAVE_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Количество двоичных разрядов числа
+ */
+constexpr int bitWidth(int value) {
+    return value ? 1 + bitWidth(value >> 1) : 0;
+}
+
+constexpr int HEIGHT_PLANES = bitWidth(BOARD_HEIGHT);     /**< Разрядов счетчика высоты столбца */
+constexpr BoardRow HIGH_BIT = BoardRow(1) << 63;          /**< За правой границей слова - стенка */
+
+/**
+ * @brief Вычитает поразрядные числа всех столбцов сразу: out = a - b
+ * @param out Разряды разности по модулю 2^HEIGHT_PLANES
+ * @return Столбцы, где a < b (заем из старшего разряда)
+ */
+TETRIS_FORCE_INLINE BoardRow subtractPlanes(const BoardRow* a, const BoardRow* b, BoardRow* out) {
+    BoardRow borrow = 0;
+    for (int k = 0; k < HEIGHT_PLANES; k++) {
+        BoardRow differ = a[k] ^ b[k];
+        out[k] = differ ^ borrow;
+        borrow = (~a[k] & b[k]) | (~differ & borrow);
+    }
+    return borrow;
+}
+
+/**
+ * @brief Сумма поразрядных чисел столбцов mask
+ */
+TETRIS_FORCE_INLINE int sumPlanes(const BoardRow* planes, BoardRow mask) {
+    int sum = 0;
+    for (int k = 0; k < HEIGHT_PLANES; k++) {
+        sum += __builtin_popcountll(planes[k] & mask) << k;
+    }
+    return sum;
+}
+
+/**
+ * @brief Досчитывает высоты, перепады и колодцы по счетчикам высот
+ * @param planes Разряды высот: бит col слова planes[k] - разряд k высоты столбца col
+ * @param columns Столбцы, по которым считаются признаки
+ * @param out Признаки; дыры и переходы уже записаны
+ * @algorithm
+ * Высоты соседей - те же разряды, сдвинутые на столбец; у крайнего
+ * столбца сосед - стенка высотой BOARD_HEIGHT. Минимум соседей, глубина
+ * колодца и модуль перепада считаются поразрядным вычитанием сразу во
+ * всех столбцах, суммы - popcount по разрядам. Цикла по столбцам нет
+ */
+TETRIS_FORCE_INLINE void finishBoard(const BoardRow* planes, BoardRow columns, BoardFeatures& out) {
+    BoardRow hasLeft = columns & (columns << 1);
+    BoardRow hasRight = columns & (columns >> 1);
+    BoardRow left[HEIGHT_PLANES];
+    BoardRow right[HEIGHT_PLANES];
+    for (int k = 0; k < HEIGHT_PLANES; k++) {
+        BoardRow wall = ((BOARD_HEIGHT >> k) & 1) ? ~BoardRow(0) : 0;
+        left[k] = ((planes[k] << 1) & hasLeft) | (wall & ~hasLeft);
+        right[k] = ((planes[k] >> 1) & hasRight) | (wall & ~hasRight);
+    }
+
+    BoardRow lower[HEIGHT_PLANES];
+    BoardRow leftLower = subtractPlanes(left, right, lower);
+    for (int k = 0; k < HEIGHT_PLANES; k++) {
+        lower[k] = (left[k] & leftLower) | (right[k] & ~leftLower);
+    }
+    BoardRow depth[HEIGHT_PLANES];
+    BoardRow notWell = subtractPlanes(lower, planes, depth);
+
+    BoardRow rise[HEIGHT_PLANES];
+    BoardRow fall[HEIGHT_PLANES];
+    BoardRow rising = subtractPlanes(planes, right, fall);
+    subtractPlanes(right, planes, rise);
+    for (int k = 0; k < HEIGHT_PLANES; k++) {
+        rise[k] = (rise[k] & rising) | (fall[k] & ~rising);
+    }
+
+    out.aggregateHeight = sumPlanes(planes, columns);
+    out.wells = sumPlanes(depth, columns & ~notWell);
+    out.bumpiness = sumPlanes(rise, hasRight);
+}
+
+/**
+ * @brief Считает признаки одного поля
+ * @param rows Строка 0 поля
+ * @param stride Расстояние между соседними строками поля в словах
+ * @algorithm
+ * Один проход сверху вниз, каждая строка - одно слово:
+ * 1. covered - столбцы, где уже встречена занятая игровая клетка;
+ *    пустые игровые клетки под ними - дыры
+ * 2. Клетки covered текущей строки прибавляются к высотам всех столбцов
+ *    сразу: высоты хранятся поразрядно (бит col слова planes[k] - разряд k
+ *    высоты столбца col), прибавление - двоичный сумматор по словам
+ * 3. Переходы вдоль строки - popcount(bits ^ (bits >> 1)) по парам клеток
+ *    с игровой клеткой, вдоль столбца - popcount(bits ^ строка выше)
+ * 4. Перепады и колодцы считаются по разрядам высот после прохода (finishBoard)
+ * @note Встраивается в версии с атрибутом target, чтобы
+ *       __builtin_popcountll стал одной командой POPCNT
+ */
+TETRIS_FORCE_INLINE void measureBoard(const BoardRow* rows, int stride, const FeatureShape& shape,
+                                      BoardFeatures& out) {
+    BoardRow planes[HEIGHT_PLANES] = {};
+    BoardRow covered = 0;
+    BoardRow previous = 0;
+    out = BoardFeatures();
+    for (int row = 0; row < BOARD_HEIGHT; row++) {
+        BoardRow bits = rows[row * stride];
+        BoardRow open = shape.open[row];
+        out.holes += __builtin_popcountll(covered & open & ~bits);
+        covered |= bits & open;
+        BoardRow carry = covered & open;
+        for (int k = 0; k < HEIGHT_PLANES && carry; k++) {
+            BoardRow next = planes[k] & carry;
+            planes[k] ^= carry;
+            carry = next;
+        }
+        out.rowTransitions += __builtin_popcountll((bits ^ ((bits >> 1) | HIGH_BIT)) & shape.rowEdges[row]);
+        out.columnTransitions += __builtin_popcountll((bits ^ previous) & shape.columnEdges[row]);
+        previous = bits;
+    }
+    finishBoard(planes, shape.columns, out);
+}
+
+/**
+ * @brief Переносимая версия для полей first..count-1
+ */
+void featuresPortable(const BoardRow* rows, int count, const FeatureShape& shape, BoardFeatures* out, int first) {
+    for (int b = first; b < count; b++) {
+        measureBoard(rows + b, count, shape, out[b]);
+    }
+}
+
+#if TETRIS_HAVE_AVX2_KERNELS
+
+/**
+ * @brief featuresPortable с командой POPCNT
+ */
+TETRIS_TARGET_POPCNT void featuresPopcnt(const BoardRow* rows, int count, const FeatureShape& shape,
+                                         BoardFeatures* out, int first) {
+    for (int b = first; b < count; b++) {
+        measureBoard(rows + b, count, shape, out[b]);
+    }
+}
+
+/**
+ * @brief Количество единичных бит каждой 64-битной дорожки
+ * @note В AVX2 нет popcount: биты считаются по тетрадам таблицей
+ *       (vpshufb), байты дорожки складываются vpsadbw
+ */
+TETRIS_TARGET_AVX2 inline __m256i popcountLanes(__m256i x) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(x, nibble));
+    __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble));
+    return _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256());
+}
+
+/**
+ * @brief measureBoard по четыре поля: поле - 64-битная дорожка
+ * @return Первое поле, которое не обработано (остаток меньше четырех)
+ * @note Строка row полей b..b+3 - четыре соседних слова rows[row * count + b]
+ */
+TETRIS_TARGET_AVX2 int featuresAvx2(const BoardRow* rows, int count, const FeatureShape& shape, BoardFeatures* out) {
+    const __m256i highBit = _mm256_set1_epi64x(static_cast<long long>(HIGH_BIT));
+    int b = 0;
+    for (; b + 4 <= count; b += 4) {
+        __m256i planes[HEIGHT_PLANES];
+        for (int k = 0; k < HEIGHT_PLANES; k++) {
+            planes[k] = _mm256_setzero_si256();
+        }
+        __m256i covered = _mm256_setzero_si256();
+        __m256i previous = _mm256_setzero_si256();
+        __m256i holes = _mm256_setzero_si256();
+        __m256i rowTransitions = _mm256_setzero_si256();
+        __m256i columnTransitions = _mm256_setzero_si256();
+        for (int row = 0; row < BOARD_HEIGHT; row++) {
+            __m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows + row * count + b));
+            __m256i open = _mm256_set1_epi64x(static_cast<long long>(shape.open[row]));
+            holes = _mm256_add_epi64(holes, popcountLanes(_mm256_andnot_si256(bits, _mm256_and_si256(covered, open))));
+            covered = _mm256_or_si256(covered, _mm256_and_si256(bits, open));
+            __m256i carry = _mm256_and_si256(covered, open);
+            for (int k = 0; k < HEIGHT_PLANES; k++) {
+                __m256i next = _mm256_and_si256(planes[k], carry);
+                planes[k] = _mm256_xor_si256(planes[k], carry);
+                carry = next;
+            }
+            __m256i neighbours = _mm256_or_si256(_mm256_srli_epi64(bits, 1), highBit);
+            __m256i rowEdges = _mm256_set1_epi64x(static_cast<long long>(shape.rowEdges[row]));
+            __m256i columnEdges = _mm256_set1_epi64x(static_cast<long long>(shape.columnEdges[row]));
+            rowTransitions = _mm256_add_epi64(rowTransitions,
+                popcountLanes(_mm256_and_si256(_mm256_xor_si256(bits, neighbours), rowEdges)));
+            columnTransitions = _mm256_add_epi64(columnTransitions,
+                popcountLanes(_mm256_and_si256(_mm256_xor_si256(bits, previous), columnEdges)));
+            previous = bits;
+        }
+
+        alignas(32) BoardRow lanePlanes[HEIGHT_PLANES][4];
+        alignas(32) BoardRow laneHoles[4];
+        alignas(32) BoardRow laneRows[4];
+        alignas(32) BoardRow laneColumns[4];
+        for (int k = 0; k < HEIGHT_PLANES; k++) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanePlanes[k]), planes[k]);
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneHoles), holes);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneRows), rowTransitions);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneColumns), columnTransitions);
+        for (int lane = 0; lane < 4; lane++) {
+            BoardRow boardPlanes[HEIGHT_PLANES];
+            for (int k = 0; k < HEIGHT_PLANES; k++) {
+                boardPlanes[k] = lanePlanes[k][lane];
+            }
+            BoardFeatures& features = out[b + lane];
+            features = BoardFeatures();
+            features.holes = static_cast<int>(laneHoles[lane]);
+            features.rowTransitions = static_cast<int>(laneRows[lane]);
+            features.columnTransitions = static_cast<int>(laneColumns[lane]);
+            finishBoard(boardPlanes, shape.columns, features);
+        }
+    }
+    return b;
+}
+
+#endif
+
+}
+
+FeatureShape::FeatureShape(const Field& field) : columns(0) {
+    for (int row = 0; row < BOARD_HEIGHT; row++) {
+        open[row] = ~field.getWallBits(row);
+        rowEdges[row] = open[row] | (open[row] >> 1);
+        columnEdges[row] = open[row] | (row > 0 ? open[row - 1] : 0);
+        columns |= open[row];
+    }
+}
+
+void extractFeatures(const BoardRow* rows, int count, const FeatureShape& shape,
+                     BoardFeatures* out, bool allowSimd) {
+    int first = 0;
+#if TETRIS_HAVE_AVX2_KERNELS
+    static const bool hasAvx2 = cpuHasAvx2();
+    static const bool hasPopcnt = cpuHasPopcnt();
+    if (allowSimd && hasAvx2) {
+        first = featuresAvx2(rows, count, shape, out);
+    }
+    if (allowSimd && hasPopcnt) {
+        featuresPopcnt(rows, count, shape, out, first);
+        return;
+    }
+#endif
+    featuresPortable(rows, count, shape, out, first);
+}
@@ -13,57 +13,82 @@
 
 using namespace std;
 
-ConsoleView::ConsoleView() {}
+ConsoleView::ConsoleView() : figureShown(false), shownFigure(), shownFieldVersion(0) {}
+
+void ConsoleView::prepareFrame(Field& field) {
+    frame.resize(field.getHeight(), field.getWidth());
+}
+
+void ConsoleView::invalidate() {
+    frame.invalidate();
+    figureShown = false;
+}
+
+bool ConsoleView::isSameState(const Figure& a, const Figure& b) {
+    return a.getType() == b.getType() && a.getRotationState() == b.getRotationState() &&
+           a.getstartx() == b.getstartx() && a.getstarty() == b.getstarty();
+}
+
+void ConsoleView::clearCell(Field& field, int row, int col) {
+    if (field.isInTargetArea(row, col)) {
+        frame.setCell(row, col, GLYPH_TARGET, COLOR_SHADOW);
+    } else {
+        frame.setCell(row, col, GLYPH_EMPTY);
+    }
+}
 
 void ConsoleView::ShowField(Field& field) {
-    if (!TerminalHelper::isTerminalSizeValid(24, 48)) {
+    if (!TerminalHelper::isTerminalSizeValid(MIN_TERMINAL_ROWS, MIN_TERMINAL_COLS)) {
         return;
     }
     
-    TerminalHelper::clearScreen();
-    TerminalHelper::moveCursorTo(0, 0);
+    prepareFrame(field);
+    figureShown = false;
+    /**
+     * @note Экран очищается только если на нем было что-то кроме поля
+     *       (меню, пауза, изменение размера). Иначе выводится только разница.
+     */
+    if (frame.isStale()) {
+        TerminalHelper::clearScreen();
+    }
     for (int i = 0; i < field.getHeight(); i++) {
         for (int j = 0; j < field.getWidth(); j++) {
             if (field.getch(i, j)) {
-                std::string color = field.getColor(i, j);
-                bool isBoundary = (i == 21) || (j == 0) || (j == 21) || 
-                                 (color == " ") || color.empty();
-                if (isBoundary) {
-                    std::cout << "\x1b[37m" << "██" << "\x1b[0m";
-                } else {
-                    std::cout << color << "██" << "\x1b[0m";
-                }
+                uint8_t color = field.getColor(i, j);
+                bool isBoundary = (i == BOARD_FLOOR_ROW) || (j == 0) || (j == BOARD_RIGHT_WALL) || 
+                                 (color == COLOR_WALL) || (color == COLOR_NONE);
+                frame.setCell(i, j, GLYPH_BLOCK, isBoundary ? static_cast<uint8_t>(COLOR_WALL) : color);
             }
             else {
-                std::cout << "  ";
+                frame.setCell(i, j, GLYPH_EMPTY);
             }
         }
-        std::cout << std::endl;
     }
-    std::cout.flush();
+    frame.present();
 }
 
 void ConsoleView::ShowPictureBackground(PictureField& pictureField) {
-    if (!TerminalHelper::isTerminalSizeValid(24, 48)) {
+    if (!TerminalHelper::isTerminalSizeValid(MIN_TERMINAL_ROWS, MIN_TERMINAL_COLS)) {
         return;
     }
     
+    prepareFrame(pictureField);
     for (int i = 0; i < pictureField.getHeight(); i++) {
         for (int j = 0; j < pictureField.getWidth(); j++) {
             if (!pictureField.getch(i, j) && pictureField.isInTargetArea(i, j)) {
-                TerminalHelper::moveCursorTo(i, j * 2);
-                std::cout << "\x1b[90m" << "▒▒" << "\x1b[0m";
+                frame.setCell(i, j, GLYPH_TARGET, COLOR_SHADOW);
             }
         }
     }
-    std::cout.flush();
+    frame.present();
 }
 
-void ConsoleView::ShowPlacedFigure(Figure& figure, Field& field) {
-    if (!TerminalHelper::isTerminalSizeValid(24, 48)) {
+void ConsoleView::ShowPlacedFigure(const Figure& figure, Field& field) {
+    if (!TerminalHelper::isTerminalSizeValid(MIN_TERMINAL_ROWS, MIN_TERMINAL_COLS)) {
         return;
     }
 
+    prepareFrame(field);
     int x = figure.getstartx();
     int y = figure.getstarty();
 
@@ -75,52 +100,30 @@ void ConsoleView::ShowPlacedFigure(Figure& figure, Field& field) {
                 
                 if (fieldY >= 0 && fieldY < field.getHeight() && 
                     fieldX >= 0 && fieldX < field.getWidth()) {
-                    
-                    TerminalHelper::moveCursorTo(fieldY, fieldX * 2);
-                    std::cout << figure.getcolor() << "██" << "\x1b[0m";
+                    frame.setCell(fieldY, fieldX, GLYPH_BLOCK, figure.getcolor());
                 }
             }
         }
     }
 
+    frame.present();
     TerminalHelper::moveCursorToSafePosition();
-    std::cout.flush();
 }
 
-void ConsoleView::ShowGhostFigure(Figure& figure, Field& field) {
-    if (!TerminalHelper::isTerminalSizeValid(24, 48)) {
+void ConsoleView::ShowGhostFigure(const Figure& figure, Field& field) {
+    if (!TerminalHelper::isTerminalSizeValid(MIN_TERMINAL_ROWS, MIN_TERMINAL_COLS)) {
         return;
     }
     
-    PictureField* pictureField = dynamic_cast<PictureField*>(&field);
-    
-    int dropDepth = 0;
+    prepareFrame(field);
+    drawGhost(figure, field);
+    frame.present();
+}
+
+void ConsoleView::drawGhost(const Figure& figure, Field& field) {
+    int dropDepth = field.getDropDistance(figure);
     int currentX = figure.getstartx();
     int currentY = figure.getstarty();
-    while (true) {
-        bool canMoveDown = true;
-        int x = figure.getstartx();
-        int y = figure.getstarty();
-        
-        for (int i = 0; i < figure.getHeight() && canMoveDown; i++) {
-            for (int j = 0; j < figure.getWidth() && canMoveDown; j++) {
-                if (figure.getchar(i, j)) {
-                    int fieldX = x + j;
-                    int fieldY = y + i + dropDepth + 1;
-                    
-                    if (!field.isValidPosition(fieldY, fieldX) || field.getch(fieldY, fieldX)) {
-                        canMoveDown = false;
-                    }
-                }
-            }
-        }
-        
-        if (canMoveDown) {
-            dropDepth++;
-        } else {
-            break;
-        }
-    }
     
     if (dropDepth > 0) {
         int ghostX = currentX;
@@ -131,26 +134,13 @@ void ConsoleView::ShowGhostFigure(Figure& figure, Field& field) {
                 if (figure.getchar(i, j)) {
                     int fieldX = ghostX + j;
                     int fieldY = ghostY + i;
-                    bool isUnderCurrentFigure = false;
-                    for (int fi = 0; fi < figure.getHeight() && !isUnderCurrentFigure; fi++) {
-                        for (int fj = 0; fj < figure.getWidth() && !isUnderCurrentFigure; fj++) {
-                            if (figure.getchar(fi, fj)) {
-                                int currentFieldX = currentX + fj;
-                                int currentFieldY = currentY + fi;
-                                if (currentFieldX == fieldX && currentFieldY == fieldY) {
-                                    isUnderCurrentFigure = true;
-                                }
-                            }
-                        }
-                    }
+                    bool isUnderCurrentFigure = figure.getchar(fieldY - currentY, fieldX - currentX);
                     
                     if (fieldY >= 0 && fieldY < field.getHeight() && 
                         fieldX >= 0 && fieldX < field.getWidth() &&
                         !field.getch(fieldY, fieldX) && 
                         !isUnderCurrentFigure) {
-                        
-                        TerminalHelper::moveCursorTo(fieldY, fieldX * 2);
-                        std::cout << "\x1b[90m" << "▓▓" << "\x1b[0m";
+                        frame.setCell(fieldY, fieldX, GLYPH_GHOST, COLOR_SHADOW);
                     }
                 }
             }
@@ -158,38 +148,17 @@ void ConsoleView::ShowGhostFigure(Figure& figure, Field& field) {
     }
 }
 
-void ConsoleView::ClearGhostFigure(Figure& figure, Field& field) {
-    if (!TerminalHelper::isTerminalSizeValid(24, 48)) {
+void ConsoleView::ClearGhostFigure(const Figure& figure, Field& field) {
+    /**
+     * @note Только стирает призрак в буфере кадра; на экран изменения
+     *       попадут вместе со следующим ShowFigure
+     */
+    if (!TerminalHelper::isTerminalSizeValid(MIN_TERMINAL_ROWS, MIN_TERMINAL_COLS)) {
         return;
     }
     
-    PictureField* pictureField = dynamic_cast<PictureField*>(&field);
-    
-    int dropDepth = 0;
-    while (true) {
-        bool canMoveDown = true;
-        int x = figure.getstartx();
-        int y = figure.getstarty();
-        
-        for (int i = 0; i < figure.getHeight() && canMoveDown; i++) {
-            for (int j = 0; j < figure.getWidth() && canMoveDown; j++) {
-                if (figure.getchar(i, j)) {
-                    int fieldX = x + j;
-                    int fieldY = y + i + dropDepth + 1;
-                    
-                    if (!field.isValidPosition(fieldY, fieldX) || field.getch(fieldY, fieldX)) {
-                        canMoveDown = false;
-                    }
-                }
-            }
-        }
-        
-        if (canMoveDown) {
-            dropDepth++;
-        } else {
-            break;
-        }
-    }
+    prepareFrame(field);
+    int dropDepth = field.getDropDistance(figure);
     
     if (dropDepth > 0) {
         int ghostX = figure.getstartx();
@@ -204,13 +173,7 @@ void ConsoleView::ClearGhostFigure(Figure& figure, Field& field) {
                     if (fieldY >= 0 && fieldY < field.getHeight() && 
                         fieldX >= 0 && fieldX < field.getWidth() &&
                         !field.getch(fieldY, fieldX)) {
-                        
-                        TerminalHelper::moveCursorTo(fieldY, fieldX * 2);
-                        if (pictureField && pictureField->isInTargetArea(fieldY, fieldX)) {
-                            std::cout << "\x1b[90m" << "▒▒" << "\x1b[0m";
-                        } else {
-                            std::cout << "  ";
-                        }
+                        clearCell(field, fieldY, fieldX);
                     }
                 }
             }
@@ -218,49 +181,53 @@ void ConsoleView::ClearGhostFigure(Figure& figure, Field& field) {
     }
 }
 void ConsoleView::ShowPictureField(Field& field) {
-    if (!TerminalHelper::isTerminalSizeValid(24, 48)) {
+    if (!TerminalHelper::isTerminalSizeValid(MIN_TERMINAL_ROWS, MIN_TERMINAL_COLS)) {
         return;
     }
     
-    TerminalHelper::clearScreen();
-    TerminalHelper::moveCursorTo(0, 0);
-    
-    PictureField* pictureField = dynamic_cast<PictureField*>(&field);
+    prepareFrame(field);
+    figureShown = false;
+    if (frame.isStale()) {
+        TerminalHelper::clearScreen();
+    }
     
     for (int i = 0; i < field.getHeight(); i++) {
         for (int j = 0; j < field.getWidth(); j++) {
-            bool isWall = (i == 21) || (j == 0) || (j == 21);
+            bool isWall = (i == BOARD_FLOOR_ROW) || (j == 0) || (j == BOARD_RIGHT_WALL);
             
             if (isWall) {
-                std::cout << "\x1b[37m" << "██" << "\x1b[0m";
+                frame.setCell(i, j, GLYPH_BLOCK, COLOR_WALL);
             }
             else if (field.getch(i, j)) {
-                std::string color = field.getColor(i, j);
-                if (!color.empty() && color != " ") {
-                    std::cout << color << "██" << "\x1b[0m";
+                uint8_t color = field.getColor(i, j);
+                if (color != COLOR_NONE && color != COLOR_WALL) {
+                    frame.setCell(i, j, GLYPH_BLOCK, color);
                 } else {
-                    std::cout << "\x1b[37m" << "██" << "\x1b[0m";
-                }
-            }
-            else if (pictureField && pictureField->isInTargetArea(i, j)) {
-                if (!field.getch(i, j)) {
-                    std::cout << "\x1b[90m" << "▒▒" << "\x1b[0m";
+                    frame.setCell(i, j, GLYPH_BLOCK, COLOR_WALL);
                 }
             }
             else {
-                std::cout << "  ";
+                clearCell(field, i, j);
             }
         }
-        std::cout << std::endl;
     }
-    std::cout.flush();
+    frame.present();
 }
-void ConsoleView::ShowFigure(Figure& oldFigure, Figure& figure, Field& field, int oldX, int oldY, int newX, int newY) {
-    if (!TerminalHelper::isTerminalSizeValid(24, 48)) {
+void ConsoleView::ShowFigure(const Figure& oldFigure, const Figure& figure, Field& field, int oldX, int oldY, int newX, int newY) {
+    if (!TerminalHelper::isTerminalSizeValid(MIN_TERMINAL_ROWS, MIN_TERMINAL_COLS)) {
+        return;
+    }
+    
+    /**
+     * @note Если фигура и поле не изменились с прошлого кадра, кадр пропускается
+     */
+    if (figureShown && !frame.isStale() && field.getVersion() == shownFieldVersion &&
+        isSameState(shownFigure, figure) && isSameState(oldFigure, figure) &&
+        oldX == newX && oldY == newY) {
         return;
     }
     
-    PictureField* pictureField = dynamic_cast<PictureField*>(&field);
+    prepareFrame(field);
     for (int i = 0; i < oldFigure.getHeight(); i++) {
         for (int j = 0; j < oldFigure.getWidth(); j++) {
             if (oldFigure.getchar(i, j)) {
@@ -270,12 +237,7 @@ void ConsoleView::ShowFigure(Figure& oldFigure, Figure& figure, Field& field, in
                 if (fieldY >= 0 && fieldY < field.getHeight() && 
                     fieldX >= 0 && fieldX < field.getWidth() &&
                     !field.getch(fieldY, fieldX)) {
-                    TerminalHelper::moveCursorTo(fieldY, fieldX * 2);
-                    if (pictureField && pictureField->isInTargetArea(fieldY, fieldX)) {
-                        std::cout << "\x1b[90m" << "▒▒" << "\x1b[0m";
-                    } else {
-                        std::cout << "  ";
-                    }
+                    clearCell(field, fieldY, fieldX);
                 }
             }
         }
@@ -289,14 +251,16 @@ void ConsoleView::ShowFigure(Figure& oldFigure, Figure& figure, Field& field, in
                 if (fieldY >= 0 && fieldY < field.getHeight() && 
                     fieldX >= 0 && fieldX < field.getWidth() &&
                     !field.getch(fieldY, fieldX)) { 
-                    
-                    TerminalHelper::moveCursorTo(fieldY, fieldX * 2);
-                    std::cout << figure.getcolor() << "██" << "\x1b[0m";
+                    frame.setCell(fieldY, fieldX, GLYPH_BLOCK, figure.getcolor());
                 }
             }
         }
     }
-    ShowGhostFigure(figure, field);
-    TerminalHelper::moveCursorToSafePosition();
-    std::cout.flush();
-}
\ No newline at end of file
+    drawGhost(figure, field);
+    figureShown = true;
+    shownFigure = figure;
+    shownFieldVersion = field.getVersion();
+    if (frame.present() > 0) {
+        TerminalHelper::moveCursorToSafePosition();
+    }
+}
@@ -0,0 +1,62 @@
+/**
+ * @file EventLoop.cpp
+ * @brief Реализация ожидания событий терминала через ppoll()
+ */
+#include "EventLoop.h"
+#include "TerminalHelper.h"
+#include "TerminalOutput.h"
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <cerrno>
+
+int EventLoop::wait(int64_t timeoutMicros, int mask) {
+    TerminalOutput::flush();
+    
+    struct pollfd fds[2];
+    int count = 0;
+    int inputIndex = -1;
+    int resizeIndex = -1;
+    
+    if (mask & EVENT_INPUT) {
+        inputIndex = count;
+        fds[count].fd = STDIN_FILENO;
+        fds[count].events = POLLIN;
+        fds[count].revents = 0;
+        count++;
+    }
+    int resizeFd = TerminalHelper::getResizeFd();
+    if ((mask & EVENT_RESIZE) && resizeFd >= 0) {
+        resizeIndex = count;
+        fds[count].fd = resizeFd;
+        fds[count].events = POLLIN;
+        fds[count].revents = 0;
+        count++;
+    }
+    
+    struct timespec timeout;
+    struct timespec* timeoutPtr = nullptr;
+    if (timeoutMicros >= 0) {
+        timeout.tv_sec = timeoutMicros / 1000000;
+        timeout.tv_nsec = (timeoutMicros % 1000000) * 1000;
+        timeoutPtr = &timeout;
+    }
+    
+    int ready = ppoll(fds, count, timeoutPtr, nullptr);
+    if (ready < 0) {
+        return errno == EINTR ? EVENT_NONE : EVENT_TIMEOUT;
+    }
+    if (ready == 0) {
+        return EVENT_TIMEOUT;
+    }
+    
+    int events = EVENT_NONE;
+    if (inputIndex >= 0 && (fds[inputIndex].revents & (POLLIN | POLLHUP))) {
+        events |= EVENT_INPUT;
+    }
+    if (resizeIndex >= 0 && (fds[resizeIndex].revents & POLLIN)) {
+        TerminalHelper::drainResizeFd();
+        events |= EVENT_RESIZE;
+    }
+    return events;
+}
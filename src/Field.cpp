@@ -6,165 +6,285 @@
  * для различных типов игровых полей.
  */
 #include "Field.h"
+#include "PictureField.h"
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
-Field::Field() : fieldmatrix(22 * 22, false), fieldcolors(22 * 22, ""), fieldWidth(22), fieldHeight(22) {
+constexpr int Field::fieldWidth;
+constexpr int Field::fieldHeight;
+
+Field::Field() : fieldcolors(BOARD_CELLS, COLOR_NONE) {
     /**
      * @brief Конструктор базового поля
      * @note Создает границы поля по периметру
      */
-    for (int i = 0; i < 22; i++) {
-        setch(21, i, true, " ");
-        setch(i, 0, true, " ");
-        setch(i, 21, true, " ");
+    outsideMask = ~((BoardRow(1) << fieldWidth) - 1);
+    rowBits.assign(fieldHeight, outsideMask);
+    wallBits.assign(fieldHeight, outsideMask);
+    validBits.assign(fieldHeight, ~outsideMask);
+    targetBits.assign(fieldHeight, 0);
+    rowFill.assign(fieldHeight, 0);
+    surfaceRow.assign(fieldWidth, fieldHeight);
+    floorRow.assign(fieldWidth, fieldHeight);
+    for (int i = 0; i < fieldWidth; i++) {
+        setch(BOARD_FLOOR_ROW, i, true, COLOR_WALL);
+    }
+    for (int i = 0; i < fieldHeight; i++) {
+        setch(i, 0, true, COLOR_WALL);
+        setch(i, BOARD_RIGHT_WALL, true, COLOR_WALL);
     }
+    captureWalls();
 }
 
-bool Field::isValidPosition(int row, int col) {
-    return (row >= 0 && row < fieldHeight && col >= 0 && col < fieldWidth);
+void Field::captureWalls() {
+    wallBits = rowBits;
+    recomputeStats();
 }
 
-std::string Field::getColor(int i, int j) {
-    if (i >= 0 && i < fieldHeight && j >= 0 && j < fieldWidth) {
-        return fieldcolors[i * fieldWidth + j];
+void Field::recomputeStats() {
+    for (int col = 0; col < fieldWidth; col++) {
+        /** Дно - первая стенка под самой верхней игровой клеткой столбца */
+        int row = 0;
+        while (row < fieldHeight && ((wallBits[row] >> col) & 1)) {
+            row++;
+        }
+        while (row < fieldHeight && !((wallBits[row] >> col) & 1)) {
+            row++;
+        }
+        floorRow[col] = row < fieldHeight ? row : 0;
+        surfaceRow[col] = floorRow[col];
     }
-    return "\x1b[37m"; 
+    
+    BoardRow pending = ~outsideMask;
+    for (int row = 0; row < fieldHeight; row++) {
+        BoardRow stack = rowBits[row] & ~wallBits[row];
+        rowFill[row] = __builtin_popcountll(stack);
+        for (BoardRow bits = stack & pending; bits; bits &= bits - 1) {
+            int col = __builtin_ctzll(bits);
+            if (row < surfaceRow[col]) {
+                surfaceRow[col] = row;
+            }
+        }
+        pending &= ~stack;
+    }
+    dirtyTop = fieldHeight;
+    dirtyBottom = -1;
 }
 
-BucketField::BucketField() {
-    fieldHeight = 22;
-    fieldWidth = 22;
-    initializeBucketShape();
+int Field::clearDirtyLines(int firstRow, int lastRow) {
+    /**
+     * @note После каждой очистки заполненных строк не остается, поэтому
+     *       новые могут появиться только среди строк, куда ставились клетки
+     */
+    int lowestFull = -1;
+    for (int row = std::min(dirtyBottom, lastRow); row >= std::max(dirtyTop, firstRow); row--) {
+        if (isRowFull(row)) {
+            lowestFull = row;
+            break;
+        }
+    }
+    dirtyTop = fieldHeight;
+    dirtyBottom = -1;
+    if (lowestFull < 0) {
+        return 0;
+    }
+    int removed = compactRows(firstRow, lowestFull);
+    recomputeStats();
+    return removed;
 }
 
-void BucketField::initializeBucketShape() {
-    rowWidths.resize(fieldHeight);
-    
-    int minWidth = 6;
-    int maxWidth = 22;
-    
-    for (int row = 0; row < fieldHeight; row++) {
-        rowWidths[row] = minWidth + (maxWidth - minWidth) * row / (fieldHeight - 1);
-    }
-    
-    fieldmatrix.clear();
-    fieldmatrix.resize(fieldHeight * fieldWidth, false);
+bool Field::isFullAfterMove(int src, int dst) const {
+    return (wallBits[dst] | (rowBits[src] & ~wallBits[src])) == ~BoardRow(0);
+}
+
+void Field::moveRow(int src, int dst) {
+    BoardRow srcWalls = wallBits[src];
+    BoardRow dstWalls = wallBits[dst];
+    rowBits[dst] = (rowBits[dst] & dstWalls) | (rowBits[src] & ~srcWalls & ~dstWalls);
     
-    for (int row = 0; row < fieldHeight; row++) {
-        int width = rowWidths[row];
-        int leftBound = (fieldWidth - width) / 2;
-        int rightBound = leftBound + width;
-        
-        for (int col = 0; col < fieldWidth; col++) {
-            bool isWall = (col < leftBound) || (col >= rightBound);
-            setch(row, col, isWall);
+    BoardRow widthMask = ~outsideMask;
+    BoardRow open = ~dstWalls & widthMask;
+    BoardRow moved = open & ~srcWalls;
+    uint8_t* dstColors = &fieldcolors[dst * fieldWidth];
+    const uint8_t* srcColors = &fieldcolors[src * fieldWidth];
+    if (moved) {
+        int first = __builtin_ctzll(moved);
+        BoardRow span = moved >> first;
+        if ((span & (span + 1)) == 0) {
+            /** Переносимые клетки идут подряд: строка цветов копируется одним memmove */
+            memmove(dstColors + first, srcColors + first, __builtin_popcountll(moved));
+        } else {
+            for (BoardRow bits = moved; bits; bits &= bits - 1) {
+                int col = __builtin_ctzll(bits);
+                dstColors[col] = srcColors[col];
+            }
         }
     }
+    for (BoardRow bits = open & ~moved; bits; bits &= bits - 1) {
+        dstColors[__builtin_ctzll(bits)] = COLOR_NONE;
+    }
+}
 
-    for (int col = 0; col < fieldWidth; col++) {
-        setch(fieldHeight - 1, col, true);
+void Field::clearRow(int row) {
+    rowBits[row] = wallBits[row];
+    uint8_t* colors = &fieldcolors[row * fieldWidth];
+    for (BoardRow bits = ~wallBits[row] & ~outsideMask; bits; bits &= bits - 1) {
+        colors[__builtin_ctzll(bits)] = COLOR_NONE;
+    }
+}
+
+int Field::compactRows(int firstRow, int lastRow) {
+    /**
+     * @brief Сжатие строк за один проход снизу вверх
+     * @algorithm
+     * 1. Идем снизу вверх; write - строка, куда ляжет следующая уцелевшая строка
+     * 2. Строка удаляется, если она была бы заполнена на месте write
+     *    (для ведра строка, сдвинутая в более широкую строку, может перестать
+     *    быть заполненной - так же, как при сдвиге по одной строке)
+     * 3. Уцелевшая строка переносится сразу на итоговое место
+     * 4. Освободившиеся сверху строки очищаются
+     */
+    int write = lastRow;
+    for (int read = lastRow; read >= 0; read--) {
+        if (write >= firstRow && isFullAfterMove(read, write)) {
+            continue;
+        }
+        if (write != read) {
+            moveRow(read, write);
+        }
+        write--;
+    }
+    int removed = write + 1;
+    for (int row = write; row >= 0; row--) {
+        clearRow(row);
     }
+    if (removed > 0) {
+        version++;
+    }
+    return removed;
 }
 
-int BucketField::getRowWidth(int row) {
-    if (row >= 0 && row < fieldHeight) {
-        return rowWidths[row];
+bool Field::collides(const Figure& figure, int x, int y) const {
+    for (int i = 0; i < figure.getHeight(); i++) {
+        BoardRow mask = figure.getRowMask(i);
+        if (!mask) continue;
+        if (x < 0) {
+            if (mask & ((BoardRow(1) << -x) - 1)) {
+                return true;
+            }
+            mask >>= -x;
+        } else {
+            mask <<= x;
+        }
+        if (getRowBits(y + i) & mask) {
+            return true;
+        }
     }
-    return fieldWidth;
+    return false;
 }
 
-bool BucketField::isValidPosition(int row, int col) {
-    if (row < 0 || row >= fieldHeight || col < 0 || col >= fieldWidth) {
-        return false;
+int Field::getDropDistance(const Figure& figure) const {
+    int x = figure.getstartx();
+    int y = figure.getstarty();
+    LandingCache& cache = landingCache;
+    if (cache.valid && cache.version == version && cache.type == figure.getType() &&
+        cache.rotation == figure.getRotationState() && cache.x == x &&
+        y >= cache.fromY && y <= cache.landingY) {
+        return cache.landingY - y;
     }
     
-    int width = getRowWidth(row);
-    int leftBound = (fieldWidth - width) / 2;
-    int rightBound = leftBound + width;
+    int depth = getSkylineDropDistance(figure);
+    if (depth < 0) {
+        depth = 0;
+        while (depth < fieldHeight && !collides(figure, x, y + depth + 1)) {
+            depth++;
+        }
+    }
     
-    return col >= leftBound && col < rightBound;
+    cache.version = version;
+    cache.type = figure.getType();
+    cache.rotation = figure.getRotationState();
+    cache.x = x;
+    cache.fromY = y;
+    cache.landingY = y + depth;
+    cache.valid = true;
+    return depth;
 }
 
-void BucketField::placeFigure(Figure& figure) {
+int Field::getSkylineDropDistance(const Figure& figure) const {
+    /**
+     * @return Глубина падения или -1, если фигура под навесом или уже пересекается с полем
+     * @note Выше поверхности столбец свободен до самой поверхности, поэтому
+     *       достаточно нижней клетки фигуры в каждом столбце
+     */
     int x = figure.getstartx();
     int y = figure.getstarty();
-
-    for (int i = 0; i < figure.getHeight(); i++) {
-        for (int j = 0; j < figure.getWidth(); j++) {
+    if (collides(figure, x, y)) {
+        return -1;
+    }
+    int depth = fieldHeight;
+    for (int j = 0; j < figure.getWidth(); j++) {
+        int lowest = -1;
+        for (int i = figure.getHeight() - 1; i >= 0 && lowest < 0; i--) {
             if (figure.getchar(i, j)) {
-                int fieldx = x + j;
-                int fieldy = y + i;
-                
-                if (isValidPosition(fieldy, fieldx)) {
-                    setch(fieldy, fieldx, true, figure.getcolor());
-                }
+                lowest = i;
             }
         }
+        if (lowest < 0) {
+            continue;
+        }
+        int limit = surfaceRow[x + j] - 1 - (y + lowest);
+        if (limit < 0) {
+            return -1;
+        }
+        depth = std::min(depth, limit);
     }
+    return depth;
 }
 
+uint8_t Field::getColor(int i, int j) const {
+    if (i >= 0 && i < fieldHeight && j >= 0 && j < fieldWidth) {
+        return fieldcolors[i * fieldWidth + j];
+    }
+    return COLOR_WALL; 
+}
 
-int BucketField::clearFullLines() {
-    /**
-     * @brief Очищает линии с учетом формы ведра
-     * @return Количество очищенных линий
-     * @note Учитывает переменную ширину строк в ведре
-     */
-    int linesCleared = 0;
-
-    for (int row = fieldHeight - 2; row >= 1; row--) { 
-        bool lineFull = true;
+BucketField::BucketField() {
+    kind = FIELD_BUCKET;
+    initializeBucketShape();
+}
 
-        int width = getRowWidth(row);
+void BucketField::initializeBucketShape() {
+    int minWidth = 6;
+    int maxWidth = fieldWidth;
+    
+    rowBits.assign(fieldHeight, outsideMask);
+    
+    for (int row = 0; row < fieldHeight; row++) {
+        int width = minWidth + (maxWidth - minWidth) * row / (fieldHeight - 1);
         int leftBound = (fieldWidth - width) / 2;
         int rightBound = leftBound + width;
+        validBits[row] = ((BoardRow(1) << rightBound) - 1) & ~((BoardRow(1) << leftBound) - 1);
         
-        for (int col = leftBound; col < rightBound; col++) {
-            if (!getch(row, col)) {
-                lineFull = false;
-                break;
-            }
+        for (int col = 0; col < fieldWidth; col++) {
+            bool isWall = (col < leftBound) || (col >= rightBound);
+            setch(row, col, isWall);
         }
+    }
 
-        if (lineFull) {
-            linesCleared++;
-            
-            for (int moveRow = row; moveRow >= 1; moveRow--) {
-                int moveWidth = getRowWidth(moveRow);
-                int moveLeftBound = (fieldWidth - moveWidth) / 2;
-                int moveRightBound = moveLeftBound + moveWidth;
-                
-                int prevWidth = getRowWidth(moveRow - 1);
-                int prevLeftBound = (fieldWidth - prevWidth) / 2;
-                int prevRightBound = prevLeftBound + prevWidth;
-                
-                for (int col = moveLeftBound; col < moveRightBound; col++) {
-                    bool value = false;
-                    std::string color = "";
-                    
-                    if (moveRow > 0 && col >= prevLeftBound && col < prevRightBound) {
-                        value = getch(moveRow - 1, col);
-                        color = getColor(moveRow - 1, col);
-                    }
-                    setch(moveRow, col, value, color);
-                }
-            }
-            
-            int topWidth = getRowWidth(0);
-            int topLeftBound = (fieldWidth - topWidth) / 2;
-            int topRightBound = topLeftBound + topWidth;
-            for (int col = topLeftBound; col < topRightBound; col++) {
-                setch(0, col, false);
-            }
-            
-            row++;
-        }
+    for (int col = 0; col < fieldWidth; col++) {
+        setch(fieldHeight - 1, col, true);
     }
-    
-    return linesCleared;
+    captureWalls();
 }
+
 void Field::placeFigure(Figure& figure) {
+    if (kind == FIELD_PICTURE) {
+        static_cast<PictureField*>(this)->placeFigure(figure);
+        return;
+    }
+    
     int x = figure.getstartx();
     int y = figure.getstarty();
 
@@ -172,78 +292,66 @@ void Field::placeFigure(Figure& figure) {
         for (int j = 0; j < figure.getWidth(); j++) {
             int fieldx = x + j;
             int fieldy = y + i;
-            if (figure.getchar(i, j)) {
+            if (figure.getchar(i, j) && isValidPosition(fieldy, fieldx)) {
                 setch(fieldy, fieldx, true, figure.getcolor());
             }
         }
     }
 }
 
-
-bool Field::getch(int i, int j) {
-    if (i >= 0 && i < fieldHeight && j >= 0 && j < fieldWidth) {
-        return fieldmatrix[i * fieldWidth + j];
+void Field::updateStats(int i, int j, bool value) {
+    if (value) {
+        rowFill[i]++;
+        if (i < surfaceRow[j]) {
+            surfaceRow[j] = i;
+        }
+        dirtyTop = std::min(dirtyTop, i);
+        dirtyBottom = std::max(dirtyBottom, i);
+        return;
+    }
+    rowFill[i]--;
+    if (i == surfaceRow[j]) {
+        int row = i + 1;
+        while (row < floorRow[j] && !(rowBits[row] & ~wallBits[row] & (BoardRow(1) << j))) {
+            row++;
+        }
+        surfaceRow[j] = row;
     }
-    return true;
 }
 
-void Field::setch(int i, int j, bool value, const std::string& color) {
+void Field::setch(int i, int j, bool value, uint8_t color) {
     if (i >= 0 && i < fieldHeight && j >= 0 && j < fieldWidth) {
         int index = i * fieldWidth + j;
-        if (index >= 0 && index < (int)fieldmatrix.size()) {
-            fieldmatrix[index] = value;
-            if (!color.empty()) {
-                if (index < (int)fieldcolors.size()) {
-                    fieldcolors[index] = color;
-                }
-            } else if (!value) {
-                if (index < (int)fieldcolors.size()) {
-                    fieldcolors[index] = "";
-                }
-            }
+        BoardRow bit = BoardRow(1) << j;
+        bool wasSet = (rowBits[i] & bit) != 0;
+        if (value) {
+            rowBits[i] |= bit;
+        } else {
+            rowBits[i] &= ~bit;
+        }
+        if (!(wallBits[i] & bit) && value != wasSet) {
+            updateStats(i, j, value);
+        }
+        if (color != COLOR_NONE) {
+            fieldcolors[index] = color;
+        } else if (!value) {
+            fieldcolors[index] = COLOR_NONE;
         }
+        version++;
     }
 }
-int Field::getHeight() { return fieldHeight; }
-int Field::getWidth() { return fieldWidth; }
 
 int Field::clearFullLines() {
     /**
      * @brief Очищает полностью заполненные линии
      * @return Количество очищенных линий
      * @algorithm
-     * 1. Проверяем линии снизу вверх (кроме дна)
-     * 2. Если линия полная, сдвигаем все линии выше на одну вниз
-     * 3. Очищаем самую верхнюю линию
-     * 4. Повторяем для следующей линии (увеличиваем счетчик, так как линии сместились)
+     * 1. Проверяем линии снизу вверх (кроме дна и верхней строки)
+     * 2. Незаполненные линии сразу переносим на итоговое место
+     * 3. Освободившиеся сверху линии очищаем
+     * @note Стоимость O(размер поля) независимо от числа очищенных линий;
+     *       проверяются только строки, куда ставились клетки.
+     *       Для ведра переменная ширина строк учитывается масками стенок wallBits
      */
-    int linesCleared = 0;
-
-    for (int row = fieldHeight - 2; row >= 1; row--) { 
-        bool lineFull = true;
-
-        for (int col = 1; col < fieldWidth - 1; col++) {
-            if (!getch(row, col)) {
-                lineFull = false;
-                break;
-            }
-        }
-
-        if (lineFull) {
-            linesCleared++;
-            for (int moveRow = row; moveRow >= 1; moveRow--) {
-                for (int col = 1; col < fieldWidth - 1; col++) {
-                    bool value = getch(moveRow - 1, col);
-                    std::string color = getColor(moveRow - 1, col);
-                    setch(moveRow, col, value, color);
-                }
-            }
-            for (int col = 1; col < fieldWidth - 1; col++) {
-                setch(0, col, false);
-            }
-            row++;
-        }
-    }
-    
-    return linesCleared;
+    return clearDirtyLines(1, fieldHeight - 2);
 }
\ No newline at end of file
@@ -2,180 +2,87 @@
  * @file Figure.cpp
  * @brief Реализация фигур Тетриса
  * 
- * Содержит матрицы форм и логику вращения для всех 7 типов фигур.
+ * Содержит таблицы форм и логику вращения для всех 7 типов фигур.
  * Каждая фигура имеет предопределенные состояния вращения.
  */
 #include "Figure.h"
 #include <algorithm>
 #include <iostream>
 
-Figure::Figure() : matrix(4, false), width(2), height(2), rotationState(0) {}
+/**
+ * @brief Таблица состояний вращения всех фигур
+ * @note Строится на этапе компиляции; индекс - [тип фигуры][состояние]
+ */
+extern constexpr PieceShape PIECE_SHAPES[PIECE_COUNT + 1][4] = {
+    // PIECE_O
+    {{2, {3, 3, 0, 0}}, {2, {3, 3, 0, 0}}, {2, {3, 3, 0, 0}}, {2, {3, 3, 0, 0}}},
+    // PIECE_L
+    {{3, {1, 1, 3, 0}}, {3, {0, 7, 1, 0}}, {3, {6, 4, 4, 0}}, {3, {0, 4, 7, 0}}},
+    // PIECE_T
+    {{3, {2, 7, 0, 0}}, {3, {2, 6, 2, 0}}, {3, {0, 7, 2, 0}}, {3, {2, 3, 2, 0}}},
+    // PIECE_I
+    {{4, {0, 15, 0, 0}}, {4, {4, 4, 4, 4}}, {4, {0, 0, 15, 0}}, {4, {2, 2, 2, 2}}},
+    // PIECE_S
+    {{3, {6, 3, 0, 0}}, {3, {2, 6, 4, 0}}, {3, {0, 6, 3, 0}}, {3, {1, 3, 2, 0}}},
+    // PIECE_Z
+    {{3, {3, 6, 0, 0}}, {3, {4, 6, 2, 0}}, {3, {0, 3, 6, 0}}, {3, {2, 3, 1, 0}}},
+    // PIECE_J
+    {{3, {4, 4, 6, 0}}, {3, {0, 7, 4, 0}}, {3, {3, 1, 1, 0}}, {3, {1, 7, 0, 0}}},
+    // PIECE_NONE
+    {{2, {0, 0, 0, 0}}, {2, {0, 0, 0, 0}}, {2, {0, 0, 0, 0}}, {2, {0, 0, 0, 0}}}
+};
 
-bool Figure::getchar(int i, int j) {
-    if (i >= 0 && i < height && j >= 0 && j < width) {
-        return matrix[i * width + j];
-    }
-    return false;
+namespace {
+/**
+ * @brief Цвета фигур по типу
+ */
+constexpr uint8_t PIECE_COLORS[PIECE_COUNT + 1] = {
+    COLOR_MAGENTA, // PIECE_O
+    COLOR_CYAN,    // PIECE_L
+    COLOR_YELLOW,  // PIECE_T
+    COLOR_BLUE,    // PIECE_I
+    COLOR_GREEN,   // PIECE_S
+    COLOR_RED,     // PIECE_Z
+    COLOR_WHITE,   // PIECE_J
+    COLOR_NONE     // PIECE_NONE
+};
 }
 
-int Figure::getstartx() { return startx; }
-int Figure::getstarty() { return starty; }
+Figure::Figure() : type(PIECE_NONE), rotationState(0) {}
+
+Figure::Figure(PieceType pieceType) : type(pieceType), rotationState(0) {}
 
-void Figure::setPosition(int x, int y) {
-    startx = x;
-    starty = y;
+uint8_t Figure::getPieceColor(PieceType pieceType) {
+    return PIECE_COLORS[pieceType <= PIECE_NONE ? pieceType : PIECE_NONE];
 }
 
-int Figure::getHeight() { return height; }
-int Figure::getWidth() { return width; }
-string Figure::getcolor() { return color; }
+bool Figure::getchar(int i, int j) const {
+    return j >= 0 && j < 4 && ((getRowMask(i) >> j) & 1);
+}
 
 void Figure::rotate() {
     /**
      * @brief Вращает фигуру на 90 градусов по часовой стрелке
-     * @note Каждый тип фигуры имеет свои предопределенные матрицы вращения
+     * @note Форма каждого состояния берется из таблицы PIECE_SHAPES
      *       Фигура O не вращается
-     *       Фигура I имеет особую логику смещения
      */
-    rotationState = (rotationState + 1) % 4;
-
-    if (color == "\x1b[35m") {
+    if (type == PIECE_O) {
         rotationState = 0;
         return;
     }
-
-    if (color == "\x1b[33m") {
-        std::vector<std::vector<bool>> tStates = {
-            {false, true, false, true, true, true, false, false, false},
-            {false, true, false, false, true, true, false, true, false},
-            {false, false, false, true, true, true, false, true, false},
-            {false, true, false, true, true, false, false, true, false}
-        };
-        matrix = tStates[rotationState];
-        width = 3;
-        height = 3;
-    }
-    else if (color == "\x1b[36m") { 
-        std::vector<std::vector<bool>> lStates = {
-            {true, false, false, true, false, false, true, true, false},
-            {false, false, false, true, true, true, true, false, false},
-            {false, true, true, false, false, true, false, false, true},
-            {false, false, false, false, false, true, true, true, true}
-        };
-        matrix = lStates[rotationState];
-        width = 3;
-        height = 3;
-    }
-    else if (color == "\x1b[37m") {
-        std::vector<std::vector<bool>> jStates = {
-            {false, false, true, false, false, true, false, true, true},
-            {false, false, false, true, true, true, false, false, true},
-            {true, true, false, true, false, false, true, false, false},
-            {true, false, false, true, true, true, false, false, false}
-        };
-        matrix = jStates[rotationState];
-        width = 3;
-        height = 3;
-    }
-    else if (color == "\x1b[32m") {
-        std::vector<std::vector<bool>> sStates = {
-            {false, true, true, true, true, false, false, false, false},
-            {false, true, false, false, true, true, false, false, true},
-            {false, false, false, false, true, true, true, true, false},
-            {true, false, false, true, true, false, false, true, false}
-        };
-        matrix = sStates[rotationState];
-        width = 3;
-        height = 3;
-    }
-    else if (color == "\x1b[31m") {
-        std::vector<std::vector<bool>> zStates = {
-            {true, true, false, false, true, true, false, false, false},
-            {false, false, true, false, true, true, false, true, false},
-            {false, false, false, true, true, false, false, true, true},
-            {false, true, false, true, true, false, true, false, false}
-        };
-        matrix = zStates[rotationState];
-        width = 3;
-        height = 3;
-    }
-    else if (color == "\x1b[34m") {
-        std::vector<std::vector<bool>> iStates = {
-            {false, false, false, false, true, true, true, true, false, false, false, false, false, false, false, false},
-            {false, false, true, false, false, false, true, false, false, false, true, false, false, false, true, false},
-            {false, false, false, false, false, false, false, false, true, true, true, true, false, false, false, false},
-            {false, true, false, false, false, true, false, false, false, true, false, false, false, true, false, false}
-        };
-        matrix = iStates[rotationState];
-        width = 4;
-        height = 4;
-    }
-}
-FigureO::FigureO() {
-    matrix = std::vector<bool>(4, true);
-    width = 2;
-    height = 2;
-    color = "\x1b[35m";
-    rotationState = 0;
+    rotationState = (rotationState + 1) % 4;
 }
 
-FigureL::FigureL() {
-    matrix = {true, false, false,
-              true, false, false,
-              true, true, false};
-    width = 3;
-    height = 3;
-    color = "\x1b[36m";
-    rotationState = 0;
-}
+FigureO::FigureO() : Figure(PIECE_O) {}
 
-FigureT::FigureT() {
-    matrix = {false, true, false,
-              true, true, true,
-              false, false, false};
-    width = 3;
-    height = 3;
-    color = "\x1b[33m";
-    rotationState = 0;
-}
+FigureL::FigureL() : Figure(PIECE_L) {}
 
-FigureI::FigureI() {
-    matrix = {false, false, false, false,
-              true, true, true, true,
-              false, false, false, false,
-              false, false, false, false};
-    width = 4;
-    height = 4;
-    color = "\x1b[34m";
-    rotationState = 0;
-}
+FigureT::FigureT() : Figure(PIECE_T) {}
 
-FigureS::FigureS() {
-    matrix = {false, true, true,
-              true, true, false,
-              false, false, false};
-    width = 3;
-    height = 3;
-    color = "\x1b[32m";
-    rotationState = 0;
-}
+FigureI::FigureI() : Figure(PIECE_I) {}
 
-FigureZ::FigureZ() {
-    matrix = {true, true, false,
-              false, true, true,
-              false, false, false};
-    width = 3;
-    height = 3;
-    color = "\x1b[31m";
-    rotationState = 0;
-}
+FigureS::FigureS() : Figure(PIECE_S) {}
 
-FigureJ::FigureJ() {
-    matrix = {false, false, true,
-              false, false, true,
-              false, true, true};
-    width = 3;
-    height = 3;
-    color = "\x1b[37m";
-    rotationState = 0;
-}
+FigureZ::FigureZ() : Figure(PIECE_Z) {}
+
+FigureJ::FigureJ() : Figure(PIECE_J) {}
\ No newline at end of file
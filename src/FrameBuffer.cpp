@@ -0,0 +1,123 @@
+/**
+ * @file FrameBuffer.cpp
+ * @brief Реализация двойного буфера клеток с выводом только изменений
+ */
+#include "FrameBuffer.h"
+#include "Palette.h"
+#include "TerminalHelper.h"
+#include "TerminalOutput.h"
+
+namespace {
+const char* const GLYPH_TEXT[] = {
+    "  ",  // GLYPH_EMPTY
+    "██",  // GLYPH_BLOCK
+    "▓▓",  // GLYPH_GHOST
+    "▒▒"   // GLYPH_TARGET
+};
+
+/**
+ * Перемещение курсора "\x1b[r;cH" занимает 6-8 байт, а пустая клетка - 2,
+ * поэтому разрыв до 3 пустых клеток выгоднее заполнить пробелами.
+ */
+const int MAX_BRIDGE_CELLS = 3;
+
+const char* const SGR_RESET = "\x1b[0m";
+}
+
+FrameBuffer::FrameBuffer() : rows(0), cols(0), generation(0), valid(false) {}
+
+void FrameBuffer::resize(int newRows, int newCols) {
+    if (newRows == rows && newCols == cols) {
+        return;
+    }
+    rows = newRows;
+    cols = newCols;
+    Cell empty = {GLYPH_EMPTY, COLOR_NONE};
+    back.assign(rows * cols, empty);
+    front.assign(rows * cols, empty);
+    valid = false;
+}
+
+void FrameBuffer::setCell(int row, int col, uint8_t glyph, uint8_t color) {
+    if (row < 0 || row >= rows || col < 0 || col >= cols) {
+        return;
+    }
+    Cell& cell = back[row * cols + col];
+    cell.glyph = glyph;
+    cell.color = glyph == GLYPH_EMPTY ? static_cast<uint8_t>(COLOR_NONE) : color;
+}
+
+bool FrameBuffer::isStale() const {
+    return !valid || generation != TerminalHelper::getScreenGeneration();
+}
+
+void FrameBuffer::invalidate() {
+    valid = false;
+}
+
+void FrameBuffer::writeCell(const Cell& cell, uint8_t& activeColor) const {
+    /**
+     * @note Пустая клетка - это пробелы, цвет текста на них не виден,
+     *       поэтому для нее цвет не переключается
+     */
+    if (cell.glyph != GLYPH_EMPTY && cell.color != activeColor) {
+        TerminalOutput::write(cell.color == COLOR_NONE ? SGR_RESET : Palette::getSGR(cell.color));
+        activeColor = cell.color;
+    }
+    TerminalOutput::write(GLYPH_TEXT[cell.glyph]);
+}
+
+bool FrameBuffer::canBridge(int row, int fromCol, int toCol) const {
+    if (toCol - fromCol > MAX_BRIDGE_CELLS) {
+        return false;
+    }
+    for (int col = fromCol; col < toCol; col++) {
+        if (front[row * cols + col].glyph != GLYPH_EMPTY) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int FrameBuffer::present() {
+    /**
+     * @brief Выводит только клетки, отличающиеся от экрана
+     * @note После очистки экрана передний буфер считается пустым, поэтому
+     *       выводятся только непустые клетки
+     */
+    if (isStale()) {
+        Cell empty = {GLYPH_EMPTY, COLOR_NONE};
+        front.assign(rows * cols, empty);
+        generation = TerminalHelper::getScreenGeneration();
+        valid = true;
+    }
+    
+    int written = 0;
+    int cursorRow = -1;
+    int cursorCol = -1;
+    uint8_t activeColor = COLOR_NONE;
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            int index = row * cols + col;
+            if (back[index] == front[index]) {
+                continue;
+            }
+            if (row == cursorRow && col > cursorCol && canBridge(row, cursorCol, col)) {
+                for (int gap = cursorCol; gap < col; gap++) {
+                    TerminalOutput::write(GLYPH_TEXT[GLYPH_EMPTY]);
+                }
+            } else if (row != cursorRow || col != cursorCol) {
+                TerminalHelper::moveCursorTo(row, col * 2);
+            }
+            writeCell(back[index], activeColor);
+            front[index] = back[index];
+            cursorRow = row;
+            cursorCol = col + 1;
+            written++;
+        }
+    }
+    if (activeColor != COLOR_NONE) {
+        TerminalOutput::write(SGR_RESET);
+    }
+    return written;
+}
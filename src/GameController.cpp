@@ -8,6 +8,10 @@
 #include "TerminalInput.h"
 #include "TerminalHelper.h"
 #include "PictureField.h"
+#include "AllocCounter.h"
+#include "GameTimer.h"
+#include "EventLoop.h"
+#include "TerminalOutput.h"
 
 #include <iostream>
 #include <unistd.h>
@@ -16,29 +20,40 @@
 #include <termios.h> 
 #include <time.h>
 
-GameController::GameController() : 
+GameController::GameController(uint64_t seed) : 
+    engine(),
     field(nullptr), 
     prevFigureX(0),
     prevFigureY(0),
-    figure(),
     view(),
     input(),
     scoreSystem(),
     settings(Settings::getInstance()),
     gameRunning(true),
     count(1),
-    score(0),
-    linesClearedTotal(0),
     playerName("Player"),
     gamePaused(false),
     isPictureMode(false),
-    nameEntered(false)
+    nameEntered(false),
+    gameSession(0),
+    baseSeed(seed),
+    loopIterations(0),
+    loopAllocations(0),
+    frameOutput(),
+    loopOutput(),
+    gravityTimer(),
+    lockStartMicros(-1),
+    bot(nullptr),
+    autoplay(false),
+    nextBotMoveMicros(0),
+    replay(),
+    replayPath()
 {
     /**
      * @brief Инициализация контроллера
-     * @note Настраивает начальную позицию фигуры и терминал
+     * @note Настраивает терминал
      */
-    figure.setPosition(10, 1);
+    TerminalOutput::install();
     TerminalHelper::initResizeHandler();
     TerminalHelper::saveScreen();
     TerminalHelper::clearScreen();
@@ -81,13 +96,7 @@ void GameController::GetPlayerName(){
 }
 
 void GameController::returnToMenu() {
-    if (field) {
-        delete field;
-        field = nullptr;
-    }
-    
-    score = 0;
-    linesClearedTotal = 0;
+    field = nullptr;
     settings->setLevel(1);
     isPictureMode = false;
     
@@ -103,42 +112,103 @@ void GameController::returnToMenu() {
             view.ShowField(*field);
         }
         
-        figure = FigureO();
-        if (isPictureMode) {
-            PictureField* pictureField = dynamic_cast<PictureField*>(field);
-            if (pictureField) {
-                pictureField->resetGame();
-                int startX = (field->getWidth() - figure.getWidth()) / 2;
-                figure.setPosition(startX, 1);
-            }
-        } else {
-            figure.setPosition(10, 1);
-        }
-        if (isPictureMode) {
-        view.ShowPictureField(*field);
-        }
-        
         showScore();
         showLevelInfo();
-        
-        if (isPictureMode) {
-            PictureField* pictureField = dynamic_cast<PictureField*>(field);
-            if (pictureField) {
-            }
-        }
     } else {
         gameRunning = false;
     }
 }
 
 GameController::~GameController() {
-    delete field;
+    finishReplay();
     field = nullptr;
+    delete bot;
     Settings::destroyInstance();
     TerminalHelper::restoreScreen();
+    if (AllocCounter::isEnabled()) {
+        std::cerr << "Выделений памяти в игровом цикле: " << loopAllocations
+                  << " за " << loopIterations << " итераций" << std::endl;
+    }
+    TerminalOutput::uninstall();
+    if (TerminalOutput::isStatsEnabled() && loopIterations > 0) {
+        std::cerr << "Вывод в терминал за кадр: "
+                  << (double)loopOutput.syscalls / loopIterations << " write(), "
+                  << (double)loopOutput.bytes / loopIterations << " байт" << std::endl;
+    }
 }
 
 void GameController::AutoMoveDown() {
+    /**
+     * @brief Применяет гравитацию и задержку фиксации
+     * @note За каждый наступивший тик фигура опускается на одну клетку.
+     *       Фигура, стоящая на опоре, фиксируется после LOCK_DELAY микросекунд
+     */
+    if (!field) return;
+    int64_t now = GameTimer::nowMicros();
+    if (!gravityTimer.isRunning()) {
+        gravityTimer.start(getGravityInterval());
+    }
+    gravityTimer.setInterval(getGravityInterval());
+    
+    int ticks = gravityTimer.consumeTicks(now, field->getHeight());
+    engine.applyGravity(ticks);
+    replay.addTicks(ticks);
+    
+    if (!engine.isGrounded()) {
+        lockStartMicros = -1;
+        return;
+    }
+    if (lockStartMicros < 0) {
+        lockStartMicros = now;
+    } else if (now - lockStartMicros >= settings->getSetting("LOCK_DELAY")) {
+        lockStartMicros = -1;
+        NewPosition();
+    }
+}
+
+int64_t GameController::getGravityInterval() const {
+    int speed = settings->getSetting("GRAVITY_SPEED");
+    if (speed <= 0) {
+        speed = Settings::getSpeedForLevel(settings->getLevel());
+    }
+    return speed;
+}
+
+int64_t GameController::getBotInterval() const {
+    int64_t delay = settings->getSetting("AUTOPLAY_DELAY");
+    return std::max<int64_t>(1000, std::min(delay, getGravityInterval() / 4));
+}
+
+void GameController::AutoPlay() {
+    if (!field || !autoplay) return;
+    int64_t now = GameTimer::nowMicros();
+    if (now < nextBotMoveMicros) {
+        return;
+    }
+    if (!bot) {
+        BeamSearchOptions options;
+        options.threads = 0;
+        bot = new BeamSearchBot(options);
+        bot->setSearchLimits(settings->getSetting("AUTOPLAY_DEPTH"), settings->getSetting("AUTOPLAY_BEAM"),
+                             settings->getSetting("AUTOPLAY_BUDGET"));
+    }
+    applyAction(bot->nextAction(engine));
+    nextBotMoveMicros = GameTimer::nowMicros() + getBotInterval();
+}
+
+int64_t GameController::getTimeUntilNextEvent(int64_t now) const {
+    int64_t wait = gravityTimer.getTimeUntilNextTick(now);
+    if (wait < 0) {
+        return 0;
+    }
+    if (lockStartMicros >= 0) {
+        int64_t lockLeft = lockStartMicros + settings->getSetting("LOCK_DELAY") - now;
+        wait = std::min(wait, std::max<int64_t>(lockLeft, 0));
+    }
+    if (autoplay) {
+        wait = std::min(wait, std::max<int64_t>(nextBotMoveMicros - now, 0));
+    }
+    return wait;
 }
 
 void GameController::DropFigure() {
@@ -147,30 +217,27 @@ void GameController::DropFigure() {
      * @note Рассчитывает глубину падения и начисляет бонусные очки
      */
     if (!field) return;
-    int oldX = figure.getstartx();
-    int oldY = figure.getstarty();
-    Figure oldFigure = figure;
-
-    int dropDepth = 0;
-    while (CanMove(0, dropDepth + 1)) {
-        dropDepth++;
-    }
+    const Figure& figure = engine.getFigure();
+    int dropDepth = field->getDropDistance(figure);
 
     if (dropDepth > 0) {
-        figure.setPosition(figure.getstartx(), figure.getstarty() + dropDepth);
-        int newX = figure.getstartx();
-        int newY = figure.getstarty();
-        view.ShowFigure(oldFigure, figure, *field, oldX, oldY, newX, newY);
+        /** Кадр с фигурой у опоры показывается до фиксации */
+        Figure landed = figure;
+        landed.setPosition(figure.getstartx(), figure.getstarty() + dropDepth);
+        view.ShowFigure(figure, landed, *field, figure.getstartx(), figure.getstarty(),
+                        landed.getstartx(), landed.getstarty());
+        std::cout.flush();
         usleep(10000);
-        
-        int dropPoints = Settings::getDropPointsForLevel(settings->getLevel()) * dropDepth;
-        addPoints(dropPoints);
+    }
+    
+    StepResult result = engine.step(ACTION_HARD_DROP);
+    if (result.dropDistance > 0) {
         int messageY = field->getHeight() + 6;
         TerminalHelper::moveCursorTo(messageY, 0);
         TerminalHelper::clearCurrentLine();
-        std::cout << "Дроп: +" << dropPoints << " очков";
+        std::cout << "Дроп: +" << result.dropPoints << " очков";
     }
-    NewPosition();
+    showLockResult(result);
 }
 
 void GameController::Input() {
@@ -180,24 +247,22 @@ void GameController::Input() {
         switch(c) {
             case 'r':
                 gamePaused = false;
+                gravityTimer.start(getGravityInterval());
+                nextBotMoveMicros = 0;
                 if (isPictureMode) {
                     view.ShowPictureField(*field);
                 } else {
                     view.ShowField(*field);
                 }
-                view.ShowPlacedFigure(figure, *field);
+                view.ShowPlacedFigure(engine.getFigure(), *field);
                 showScore();
                 showLevelInfo();
-                if (isPictureMode) {
-                    PictureField* pictureField = (PictureField*)field;
-                }
                 break;
             case 'q':
                 gameRunning = false;
                 return;
             case 'n':
                 gamePaused = false;
-                delete field;
                 field = nullptr;
                 TerminalHelper::clearScreen();
             if (GameMenu()) {
@@ -206,15 +271,8 @@ void GameController::Input() {
                 } else {
             view.ShowField(*field);
                  }
-        figure = FigureO();
         showScore();
         showLevelInfo();
-        if (isPictureMode) {
-            PictureField* pictureField = (PictureField*)field;
-            if (pictureField) {
-                view.ShowPictureField(*field);
-            }
-                }
             } else {
             gameRunning = false;
             }
@@ -233,58 +291,72 @@ void GameController::Input() {
         return;
     }
     
-    if (c == settings->getControl("LEFT") || c == '<') {
-        if (CanMove(-1, 1)) {
-            view.ClearGhostFigure(figure, *field);
-            figure.setPosition(figure.getstartx() - 1, figure.getstarty()+1);
-        }
+    if (c == settings->getControl("PAUSE")) {
+        gamePaused = true;
+        ShowPauseMenu();
+    }
+    else if (c == settings->getControl("QUIT")) {
+        gameRunning = false;
+    }
+    else if (autoplay) {
+        /** В автоигре фигурой управляет бот: работают только пауза и выход */
+        return;
+    }
+    else if (c == settings->getControl("LEFT") || c == '<') {
+        applyAction(ACTION_LEFT);
     }
     else if (c == settings->getControl("RIGHT") || c == '>') {
-        if (CanMove(1, 1)) {
-            view.ClearGhostFigure(figure, *field);
-            figure.setPosition(figure.getstartx() + 1, figure.getstarty()+1);
-        }
+        applyAction(ACTION_RIGHT);
     }
     else if (c == settings->getControl("DOWN") || c == 'v') {
-        if (CanMove(0, 1)) {
-            figure.setPosition(figure.getstartx(), figure.getstarty() + 1);
-            addPoints(40 * settings->getLevel());
-            showScore();
-        }
+        applyAction(ACTION_SOFT_DROP);
     }
     else if (c == settings->getControl("DROP") || c == '^') {
-        DropFigure();
+        applyAction(ACTION_HARD_DROP);
     }
     else if (c == settings->getControl("ROTATE")) {
-        if (CanRotate()) {
-            view.ClearGhostFigure(figure, *field);
-            figure.rotate();
-            if (CanMove(0, 1)) {
-            figure.setPosition(figure.getstartx(), figure.getstarty() + 1);
-        }
-        }
-    }
-    else if (c == settings->getControl("PAUSE")) {
-        gamePaused = true;
-        ShowPauseMenu();
+        applyAction(ACTION_ROTATE);
     }
-    else if (c == settings->getControl("QUIT")) {
-        gameRunning = false;
+}
+
+void GameController::applyAction(EngineAction action) {
+    Figure oldFigure = engine.getFigure();
+    switch (action) {
+        case ACTION_LEFT:
+        case ACTION_RIGHT:
+        case ACTION_ROTATE:
+            replay.record(action);
+            if (engine.step(action).moved) {
+                view.ClearGhostFigure(oldFigure, *field);
+            }
+            break;
+        case ACTION_SOFT_DROP:
+            replay.record(action);
+            if (engine.step(ACTION_SOFT_DROP).moved) {
+                showScore();
+            }
+            break;
+        case ACTION_HARD_DROP:
+            replay.record(action);
+            DropFigure();
+            break;
+        default:
+            break;
     }
 }
 
 void GameController::ShowPauseMenu() {
     TerminalHelper::moveCursorTo(0, 0);
     TerminalHelper::clearScreen();
-    std::cout << "=== ПАУЗА ===" << std::endl;
-    std::cout << "Игрок: " << playerName << " | Текущий счет: " << score << std::endl;
-    std::cout << "Уровень: " << settings->getLevel() << " | Линий очищено: " << linesClearedTotal << std::endl;
-    std::cout << "----------------------------" << std::endl;
-    std::cout << "Нажмите r чтобы вернуться в игру" << std::endl;
-    std::cout << "Нажмите n чтобы начать новую игру" << std::endl;
-    std::cout << "Нажмите s чтобы открыть настройки" << std::endl;
-    std::cout << "Нажмите v чтобы посмотреть рекорды" << std::endl;
-    std::cout << "Нажмите q чтобы выйти" << std::endl;
+    std::cout << "=== ПАУЗА ===" << "\n";
+    std::cout << "Игрок: " << playerName << " | Текущий счет: " << engine.getScore() << "\n";
+    std::cout << "Уровень: " << settings->getLevel() << " | Линий очищено: " << engine.getLinesCleared() << "\n";
+    std::cout << "----------------------------" << "\n";
+    std::cout << "Нажмите r чтобы вернуться в игру" << "\n";
+    std::cout << "Нажмите n чтобы начать новую игру" << "\n";
+    std::cout << "Нажмите s чтобы открыть настройки" << "\n";
+    std::cout << "Нажмите v чтобы посмотреть рекорды" << "\n";
+    std::cout << "Нажмите q чтобы выйти" << "\n";
     std::cout.flush();
 }
 
@@ -340,8 +412,6 @@ void GameController::ShowSettingsMenu(bool fromPause) {
     else if (!fromPause && (choice == '0' || choice == 'q')) {
         return;
     }
-    
-    usleep(10000);
 }
 }
 
@@ -408,7 +478,6 @@ while (true) {
             if (newKey != 0) {
                 break;
             }
-            usleep(10000);
         }
         
         if (newKey == '0') {
@@ -436,8 +505,6 @@ while (true) {
         ShowControlSettings();
         return;
     }
-    
-    usleep(10000);
 }
 }
 
@@ -459,8 +526,22 @@ void GameController::ShowCurrentSettings() {
     std::cout << "  Текущий уровень: " << settings->getLevel() << std::endl;
     std::cout << "  Скорость падения: " << Settings::getSpeedForLevel(settings->getLevel()) 
               << " мкс" << std::endl;
-    std::cout << "  Баллы за дроп: " << Settings::getDropPointsForLevel(settings->getLevel()) 
+    std::cout << "  Баллы за дроп: " << TetrisEngine::getDropPointsForLevel(settings->getLevel()) 
               << " за клетку" << std::endl;
+    std::cout << "  Задержка фиксации: " << settings->getSetting("LOCK_DELAY") 
+              << " мкс" << std::endl;
+    std::cout << "  Задержка автоигры: " << settings->getSetting("AUTOPLAY_DELAY") 
+              << " мкс" << std::endl;
+    std::cout << "  Поиск автоигры: " << settings->getSetting("AUTOPLAY_DEPTH") << " фигуры, луч "
+              << settings->getSetting("AUTOPLAY_BEAM") << ", " << settings->getSetting("AUTOPLAY_BUDGET")
+              << " мкс на фигуру" << std::endl;
+    static const char* const randomizerNames[RANDOMIZER_COUNT] = {"случайно", "мешок из 7", "история"};
+    int randomizer = settings->getSetting("RANDOMIZER");
+    std::cout << "  Генератор фигур: "
+              << (randomizer >= 0 && randomizer < RANDOMIZER_COUNT ? randomizerNames[randomizer] : randomizerNames[0])
+              << std::endl;
+    std::cout << "  Запись повторов: " << (settings->getSetting("REPLAY_RECORD") == 1 ? "включена" : "выключена")
+              << std::endl;
 }
 
 void GameController::ShowMainSettingsMenu() {
@@ -510,7 +591,6 @@ while (true) {
                 ShowMainSettingsMenu();
                 return;
             }
-            usleep(10000);
         }
     }
     else if (choice == '4') {
@@ -519,8 +599,6 @@ while (true) {
     else if (choice == '0' || choice == 'q') {
         return;
     }
-    
-    usleep(10000);
 }
 }
 
@@ -528,169 +606,120 @@ bool GameController::CanRotate() {
     /**
      * @brief Проверяет возможность поворота текущей фигуры
      * @return true если поворот возможен без столкновений
-     * @note Для фигуры I учитывает смещение при вращении
      */
     if (!field) return false;
-    int oldX = figure.getstartx();
-    int oldY = figure.getstarty();
-    std::string oldColor = figure.getcolor();
-    Figure testFigure;
-    if (oldColor == "\x1b[35m") testFigure = FigureO();
-    else if (oldColor == "\x1b[36m") testFigure = FigureL();
-    else if (oldColor == "\x1b[33m") testFigure = FigureT();
-    else if (oldColor == "\x1b[34m") testFigure = FigureI();
-    else if (oldColor == "\x1b[32m") testFigure = FigureS();
-    else if (oldColor == "\x1b[31m") testFigure = FigureZ();
-    else if (oldColor == "\x1b[37m") testFigure = FigureJ();
-    testFigure.setPosition(oldX, oldY);
-    for (int i = 0; i < figure.getRotationState(); i++) {
-        testFigure.rotate();
-    }
-    testFigure.rotate();
-    if (oldColor == "\x1b[34m") {
-        if (figure.getRotationState() % 2 == 0) {
-            testFigure.setPosition(oldX - 1, oldY);
-        } else {
-            testFigure.setPosition(oldX + 1, oldY);
-        }
-    }
-    
-    bool canRotate = true;
-    int x = testFigure.getstartx();
-    int y = testFigure.getstarty();
-    
-    for (int i = 0; i < testFigure.getHeight() && canRotate; i++) {
-        for (int j = 0; j < testFigure.getWidth() && canRotate; j++) {
-            if (testFigure.getchar(i, j)) {
-                int fieldX = x + j;
-                int fieldY = y + i;
-
-                if (!field->isValidPosition(fieldY, fieldX)) {
-                    canRotate = false;
-                }
-                
-                if (field->getch(fieldY, fieldX)) {
-                    canRotate = false;
-                }
-            }
-        }
-    }
-    
-    return canRotate;
+    return engine.canRotate();
 }
 
 bool GameController::CanMove(int dx, int dy) {
     if (!field) return false;
     
-    int newX = figure.getstartx() + dx;
-    int newY = figure.getstarty() + dy;
- 
-    for (int i = 0; i < figure.getHeight(); i++) {
-        for (int j = 0; j < figure.getWidth(); j++) {
-            if (figure.getchar(i, j)) {
-                int fieldX = newX + j;
-                int fieldY = newY + i;
+    return engine.canMove(dx, dy);
+}
 
-                if (!field->isValidPosition(fieldY, fieldX)) {
-                    return false;
-                }
-                
-                if (field->getch(fieldY, fieldX)) {
-                    return false;
-                }
-            }
+void GameController::startGame(GameMode mode) {
+    int randomizer = settings->getSetting("RANDOMIZER");
+    if (randomizer < 0 || randomizer >= RANDOMIZER_COUNT) {
+        randomizer = RANDOMIZER_RANDOM;
+    }
+    finishReplay();
+    engine.reset(baseSeed + gameSession, mode, static_cast<RandomizerKind>(randomizer));
+    field = engine.getField();
+    isPictureMode = engine.isPictureMode();
+    
+    if (settings->getSetting("REPLAY_RECORD") == 1) {
+        ReplayHeader header;
+        header.mode = mode;
+        header.pictureType = isPictureMode ? asPictureField(field)->getPictureType() : 0;
+        header.randomizer = static_cast<RandomizerKind>(randomizer);
+        header.seed = baseSeed + gameSession;
+        static const char* const recordedSettings[] = {"LEVEL", "GRAVITY_SPEED", "LOCK_DELAY", "RANDOMIZER"};
+        for (const char* name : recordedSettings) {
+            header.settings.push_back(std::make_pair(std::string(name), settings->getSetting(name)));
         }
+        header.settings.push_back(std::make_pair(std::string("AUTOPLAY"), autoplay ? 1 : 0));
+        replayPath = "tetris_replay_" + std::to_string(header.seed) + ".ttr";
+        replay.start(header);
+    }
+}
+
+void GameController::finishReplay() {
+    if (replay.isRecording()) {
+        replay.finish(replayPath, engine);
     }
-    return true;
 }
 
 void GameController::NewPosition() {
     /**
-     * @brief Обновляет позицию фигуры или создает новую
-     * @note Вызывается когда фигура не может двигаться вниз
-     *       Размещает фигуру на поле, проверяет линии, создает новую фигуру
+     * @brief Фиксирует фигуру или ничего не делает, если она может опуститься
+     * @note Размещение, очистку линий и новую фигуру выполняет движок
      */
     if (!field) return;
-        
-    if (CanMove(0, 1)) {
+    replay.record(ACTION_LOCK);
+    showLockResult(engine.step(ACTION_LOCK));
+}
+
+void GameController::showLockResult(const StepResult& result) {
+    if (!result.locked) {
         return;
-    } 
-    
-    field->placeFigure(figure);
-    view.ShowPlacedFigure(figure, *field);
-    
-    if (isPictureMode) {
-        PictureField* pictureField = dynamic_cast<PictureField*>(field);
-        if (pictureField) {
-            if (pictureField->isGameOver()) {
-                showGameOverScreen(true);
-                return;
-            }
-        }
-    } else {
-        int linesCleared = field->clearFullLines();
-if (linesCleared > 0) {
-    linesClearedTotal += linesCleared;
-    
-    int points = 0;
-    switch(linesCleared) {
-        case 1: points = 100; break;
-        case 2: points = 300; break;
-        case 3: points = 500; break;
-        case 4: points = 800; break;
     }
-    points *= settings->getLevel();
-    
-    addPoints(points);
-    
-    int messageY = field->getHeight() + 6; 
-    TerminalHelper::moveCursorTo(messageY, 0);
-    TerminalHelper::clearCurrentLine();
-    std::cout << "Очищено: " << linesCleared << " линий | +" << points << " очков";
-    
-    showScore();
-    updateLevel();
-    view.ShowField(*field);
-    showScore();
-    showLevelInfo();
-    TerminalHelper::moveCursorTo(messageY, 0);
-    TerminalHelper::clearCurrentLine();
-    std::cout << "Очищено: " << linesCleared << " линий | +" << points << " очков";
-    view.ShowGhostFigure(figure, *field);
     
-    TerminalHelper::moveCursorToSafePosition();
-    std::cout.flush();
-}
-    }
-        int figureType;
-        figureType = rand() % 7;
-
-    switch(figureType) {
-        case 0: figure = FigureO(); break;
-        case 1: figure = FigureL(); break;
-        case 2: figure = FigureT(); break;
-        case 3: figure = FigureI(); break;
-        case 4: figure = FigureS(); break;
-        case 5: figure = FigureZ(); break;
-        case 6: figure = FigureJ(); break;
+    if (result.linesCleared == 0) {
+        view.ShowPlacedFigure(result.lockedFigure, *field);
     }
+    
     if (isPictureMode) {
-        int startX = (field->getWidth() - figure.getWidth()) / 2;
-        figure.setPosition(startX, 1);
-    } else {
-        figure.setPosition(10, 1);
+        if (result.pictureComplete) {
+            TerminalHelper::moveCursorTo(PICTURE_MESSAGE_ROW, 0);
+            TerminalHelper::clearCurrentLine();
+            std::cout << "\x1b[32m" << "ПОЗДРАВЛЯЕМ! Вы собрали картинку: " 
+                      << asPictureField(field)->getPictureName() << "!" << "\x1b[0m";
+            std::cout.flush();
+            usleep(3000000);
+        }
+        if (result.pictureBroken) {
+            TerminalHelper::moveCursorTo(PICTURE_MESSAGE_ROW, 0);
+            TerminalHelper::clearCurrentLine();
+            std::cout << "\x1b[31m" << "ИГРА ОКОНЧЕНА! Часть фигуры вышла за границы картинки." << "\x1b[0m";
+            std::cout.flush();
+            usleep(3000000);
+        }
+        if (result.pictureComplete || result.pictureBroken) {
+            showGameOverScreen(true);
+            return;
+        }
+    } else if (result.linesCleared > 0) {
+        int messageY = field->getHeight() + 6; 
+        TerminalHelper::moveCursorTo(messageY, 0);
+        TerminalHelper::clearCurrentLine();
+        std::cout << "Очищено: " << result.linesCleared << " линий | +" << result.linePoints << " очков";
+        
+        showScore();
+        updateLevel();
+        view.ShowField(*field);
+        showScore();
+        showLevelInfo();
+        TerminalHelper::moveCursorTo(messageY, 0);
+        TerminalHelper::clearCurrentLine();
+        std::cout << "Очищено: " << result.linesCleared << " линий | +" << result.linePoints << " очков";
+        view.ShowGhostFigure(engine.getFigure(), *field);
+        
+        TerminalHelper::moveCursorToSafePosition();
     }
+    gravityTimer.start(getGravityInterval());
+    lockStartMicros = -1;
     
-    if (!CanMove(0, 0)) {
+    if (result.gameOver) {
         showGameOverScreen(false);
     }
 }
 
 void GameController::showGameOverScreen(bool isPictureModeGameOver) {
+    finishReplay();
     TerminalHelper::clearScreen();
     
     if (isPictureModeGameOver) {
-        PictureField* pictureField = dynamic_cast<PictureField*>(field);
+        PictureField* pictureField = asPictureField(field);
         if (pictureField) {
             std::cout << "=== ИГРА ОКОНЧЕНА ===\n\n";
             std::cout << "Картинка: " << pictureField->getPictureName() << "\n";
@@ -699,25 +728,20 @@ void GameController::showGameOverScreen(bool isPictureModeGameOver) {
     } else {
         std::cout << "=== ИГРА ОКОНЧЕНА ===\n\n";
         std::cout << "Игрок: " << playerName << std::endl;
-        std::cout << "Итоговый счет: " << score << std::endl;
+        std::cout << "Итоговый счет: " << engine.getScore() << std::endl;
         std::cout << "Уровень: " << settings->getLevel() << std::endl;
-        std::cout << "Очищено линий: " << linesClearedTotal << "\n\n";
+        std::cout << "Очищено линий: " << engine.getLinesCleared() << "\n\n";
     }
-    if (score > 0) {
-        scoreSystem.addScore(playerName, score);
+    if (engine.getScore() > 0 && !autoplay) {
+        scoreSystem.addScore(playerName, engine.getScore());
     }
     scoreSystem.displayScores();
     
     std::cout << "\nНажмите любую клавишу для возврата в меню...";
     std::cout.flush();
     input.getInput();
-    if (field) {
-        delete field;
-        field = nullptr;
-    }
+    field = nullptr;
     
-    score = 0;
-    linesClearedTotal = 0;
     settings->setLevel(1);
     isPictureMode = false;
     gamePaused = false;
@@ -730,18 +754,6 @@ void GameController::showGameOverScreen(bool isPictureModeGameOver) {
             view.ShowField(*field);
         }
         
-        figure = FigureO();
-        if (isPictureMode) {
-            PictureField* pictureField = dynamic_cast<PictureField*>(field);
-            if (pictureField) {
-                pictureField->resetGame();
-                int startX = (field->getWidth() - figure.getWidth()) / 2;
-                figure.setPosition(startX, 1);
-            }
-        } else {
-            figure.setPosition(10, 1);
-        }
-        
         showScore();
         showLevelInfo();
     } else {
@@ -750,22 +762,16 @@ void GameController::showGameOverScreen(bool isPictureModeGameOver) {
     }
 }
 
-void GameController::addPoints(int points) {
-    score += points;
-}
-
 void GameController::updateLevel() {
-    int currentLevel = settings->getLevel();
-    int requiredLines = settings->getLinesForNextLevel();
-    
-    if (linesClearedTotal >= requiredLines) {
-        settings->setLevel(currentLevel + 1);
+    if (engine.getLevel() != settings->getLevel()) {
+        settings->setLevel(engine.getLevel());
         showLevelInfo();
         
         int messageY = field->getHeight() + 6;
         TerminalHelper::moveCursorTo(messageY, 0);
         TerminalHelper::clearCurrentLine();
         std::cout << "НОВЫЙ УРОВЕНЬ: " << settings->getLevel() << "!";
+        std::cout.flush();
         usleep(1000000);
     }
 }
@@ -778,18 +784,17 @@ void GameController::showLevelInfo() {
     TerminalHelper::moveCursorTo(startY, startX);
     TerminalHelper::clearCurrentLine();
     if (isPictureMode) {
-        PictureField* pictureField = (PictureField*)field;
+        PictureField* pictureField = asPictureField(field);
         std::cout << "Режим: Собери картинку | Картинка: " << pictureField->getPictureName();
     } else {
         std::cout << "Уровень: " << settings->getLevel() 
                   << " | Линий до след. уровня: " 
-                  << std::max(0, settings->getLinesForNextLevel() - linesClearedTotal)
-                  << " | Дроп: +" << Settings::getDropPointsForLevel(settings->getLevel()) 
+                  << std::max(0, settings->getLinesForNextLevel() - engine.getLinesCleared())
+                  << " | Дроп: +" << TetrisEngine::getDropPointsForLevel(settings->getLevel()) 
                   << " очков/клетка";
     }
     
     TerminalHelper::moveCursorToSafePosition();
-    std::cout.flush();
 }
 
 void GameController::showScore() {
@@ -800,7 +805,7 @@ void GameController::showScore() {
     TerminalHelper::moveCursorTo(startY, startX);
     TerminalHelper::clearCurrentLine();
     if (isPictureMode) {
-        PictureField* pictureField = dynamic_cast<PictureField*>(field);
+        PictureField* pictureField = asPictureField(field);
         if (pictureField) {
             std::cout << "=== КАРТИНКА: " << pictureField->getPictureName() << " ===";
         } else {
@@ -812,7 +817,7 @@ void GameController::showScore() {
     
     TerminalHelper::moveCursorTo(startY + 1, startX);
     TerminalHelper::clearCurrentLine();
-    std::cout << "Игрок: " << playerName << " | Счет: " << score;
+    std::cout << "Игрок: " << (autoplay ? "АВТОИГРА" : playerName) << " | Счет: " << engine.getScore();
     TerminalHelper::moveCursorTo(startY + 2, startX);
     TerminalHelper::clearCurrentLine();
     
@@ -837,7 +842,6 @@ void GameController::showScore() {
               << quit << "-выход";
     
     TerminalHelper::moveCursorToSafePosition();
-    std::cout.flush();
 }
 
 bool GameController::GameMenu() {
@@ -846,8 +850,11 @@ bool GameController::GameMenu() {
      * @return true если пользователь выбрал игру, false для выхода
      * @note Позволяет выбрать режим игры, просмотреть рекорды, настроить управление
      */
-    score = 0;
-    linesClearedTotal = 0;
+    gameSession++;
+    gravityTimer.stop();
+    lockStartMicros = -1;
+    autoplay = false;
+    nextBotMoveMicros = 0;
     settings->setLevel(1);
     isPictureMode = false;
     if (!nameEntered) {
@@ -872,6 +879,7 @@ bool GameController::GameMenu() {
     std::cout << "2. Таблица рекордов" << std::endl;
     std::cout << "3. Настройки" << std::endl;
     std::cout << "4. Выход" << std::endl;
+    std::cout << "5. Автоигра (демо)" << std::endl;
     
     char c;
     do {
@@ -883,6 +891,7 @@ bool GameController::GameMenu() {
             std::cout << "2. Таблица рекордов" << std::endl;
             std::cout << "3. Настройки" << std::endl;
             std::cout << "4. Выход" << std::endl;
+            std::cout << "5. Автоигра (демо)" << std::endl;
         }
         else if (c == '3') {
             ShowMainSettingsMenu();
@@ -903,12 +912,19 @@ bool GameController::GameMenu() {
             std::cout << "2. Таблица рекордов" << std::endl;
             std::cout << "3. Настройки" << std::endl;
             std::cout << "4. Выход" << std::endl;
+            std::cout << "5. Автоигра (демо)" << std::endl;
         }
         else if (c == '4') {
             return false;
         }
-        usleep(10000);
-    } while (c != '1');
+        else if (c == '5') {
+            autoplay = true;
+            if (bot) {
+                bot->setSearchLimits(settings->getSetting("AUTOPLAY_DEPTH"), settings->getSetting("AUTOPLAY_BEAM"),
+                                     settings->getSetting("AUTOPLAY_BUDGET"));
+            }
+        }
+    } while (c != '1' && c != '5');
     
     TerminalHelper::clearScreen();
     std::cout << "Выберите игру:\n";
@@ -920,19 +936,16 @@ bool GameController::GameMenu() {
     char gameChoice;
     do {
         gameChoice = input.getInput();
-        usleep(10000);
     } while (gameChoice < '1' || gameChoice > '3');
     
     if (gameChoice == '1') {
-        field = new Field();
-        isPictureMode = false;
+        startGame(MODE_CLASSIC);
         std::cout << "Выбрана классическая игра!" << std::endl;
         usleep(1000000);
         return true;
     } 
     else if (gameChoice == '2') {
-        field = new BucketField();
-        isPictureMode = false;
+        startGame(MODE_BUCKET);
         std::cout << "Выбрана игра 'Ведро'!" << std::endl;
         usleep(1000000);
         return true;
@@ -952,31 +965,16 @@ bool GameController::GameMenu() {
         char picChoice;
         do {
             picChoice = input.getInput();
-            usleep(10000);
         } while (picChoice < '1' || picChoice > '2');
         
-        int pictureType = PICTURE_SQUARE;
+        GameMode pictureMode = MODE_PICTURE_SQUARE;
         switch(picChoice) {
-            case '1': pictureType = PICTURE_SQUARE; break;
-            case '2': pictureType = PICTURE_TRIANGLE; break;
-            case '3': pictureType = PICTURE_HOUSE; break;
-            case '4': pictureType = PICTURE_ARROW; break;
-            case '5': pictureType = PICTURE_BUTTERFLY; break;
-            case '6': pictureType = PICTURE_STAR; break;
+            case '1': pictureMode = MODE_PICTURE_SQUARE; break;
+            case '2': pictureMode = MODE_PICTURE_TRIANGLE; break;
         }
         
-        if (field) {
-            delete field;
-            field = nullptr;
-        }
-        score = 0;
-        linesClearedTotal = 0;
         count = 1;
-        field = new PictureField(pictureType);
-        isPictureMode = true;
-        PictureField* pictureField = dynamic_cast<PictureField*>(field);
-        if (pictureField) {
-        pictureField->resetGame();}
+        startGame(pictureMode);
         TerminalHelper::clearScreen();
         std::cout << "=== СОБЕРИ КАРТИНКУ ===\n\n";
         std::cout << "Задача: заполните серую область фигурами\n";
@@ -993,10 +991,10 @@ bool GameController::GameMenu() {
 }
 
 void GameController::run() {
-    if (!TerminalHelper::isTerminalSizeValid(24, 48)) {
+    if (!TerminalHelper::isTerminalSizeValid(MIN_TERMINAL_ROWS, MIN_TERMINAL_COLS)) {
         int rows, cols;
         TerminalHelper::getCurrentSize(rows, cols);
-        std::cerr << "Размер терминала слишком маленький! Минимум: 24 строки x 48 столбцов" << std::endl;
+        std::cerr << "Размер терминала слишком маленький! Минимум: " << MIN_TERMINAL_ROWS << " строки x " << MIN_TERMINAL_COLS << " столбцов" << std::endl;
         std::cerr << "Текущий размер: " << cols << "x" << rows << std::endl;
         return;
     }
@@ -1013,74 +1011,85 @@ void GameController::run() {
             view.ShowField(*field);
         }
         
-        figure = FigureO();
         showScore();
         showLevelInfo();
         
-        if (isPictureMode) {
-            PictureField* pictureField = (PictureField*)field;
-        }
-        
         int messageY = field->getHeight() + 6;
         TerminalHelper::moveCursorTo(messageY, 0);
         TerminalHelper::clearCurrentLine();
         
         while (gameRunning) {
             if (TerminalHelper::wasResized()) {
-                if (!TerminalHelper::isTerminalSizeValid(24, 48)) {
+                if (!TerminalHelper::isTerminalSizeValid(MIN_TERMINAL_ROWS, MIN_TERMINAL_COLS)) {
                     TerminalHelper::clearScreen();
                     int rows, cols;
                     TerminalHelper::getCurrentSize(rows, cols);
                     std::cout << "Размер терминала слишком маленький!" << std::endl;
                     std::cout << "Текущий размер: " << cols << "x" << rows << std::endl;
-                    std::cout << "Требуется: 24 строки x 48 столбцов" << std::endl;
+                    std::cout << "Требуется: " << MIN_TERMINAL_ROWS << " строки x " << MIN_TERMINAL_COLS << " столбцов" << std::endl;
                     usleep(2000000);
                 } else if (!gamePaused) {
+                    view.invalidate();
                     if (isPictureMode) {
                         view.ShowPictureField(*field);
                     } else {
                         view.ShowField(*field);
                     }
-                    view.ShowPlacedFigure(figure, *field);
+                    view.ShowPlacedFigure(engine.getFigure(), *field);
                     showScore();
                     showLevelInfo();
-                    if (isPictureMode) {
-                        PictureField* pictureField = (PictureField*)field;
-                    }
                 }
             }
             
-            if (!TerminalHelper::isTerminalSizeValid(24, 48)) {
+            if (!TerminalHelper::isTerminalSizeValid(MIN_TERMINAL_ROWS, MIN_TERMINAL_COLS)) {
                 TerminalHelper::clearScreen();
-                int rows, cols;
-                TerminalHelper::getCurrentSize(rows, cols);
-                usleep(100000);
+                if (EventLoop::wait(-1) & EVENT_INPUT) {
+                    Input();
+                }
                 continue;
             }
             
             if (gamePaused) {
-                Input();
-                usleep(50000);
+                if (EventLoop::wait(-1) & EVENT_INPUT) {
+                    Input();
+                }
                 continue;
             }
             
-            int oldX = figure.getstartx();
-            int oldY = figure.getstarty();
-            Figure oldFigure = figure;
+            uint64_t allocationsBefore = AllocCounter::getCount();
+            OutputCounters outputBefore = TerminalOutput::getCounters();
+            int sessionBefore = gameSession;
+            Figure oldFigure = engine.getFigure();
+            int oldX = oldFigure.getstartx();
+            int oldY = oldFigure.getstarty();
 
-            Input();
-            if (gamePaused) {
-                continue;
+            int events = EventLoop::wait(getTimeUntilNextEvent(GameTimer::nowMicros()));
+            if (events & EVENT_INPUT) {
+                Input();
+                if (gamePaused) {
+                    continue;
+                }
             }
 
-            NewPosition();
+            AutoPlay();
+            AutoMoveDown();
 
+            const Figure& figure = engine.getFigure();
             int newX = figure.getstartx();
             int newY = figure.getstarty();
 
             view.ShowFigure(oldFigure, figure, *field, oldX, oldY, newX, newY);
+            TerminalOutput::flush();
 
-            usleep(5000);
+            if (gameRunning && gameSession == sessionBefore) {
+                OutputCounters outputAfter = TerminalOutput::getCounters();
+                frameOutput.syscalls = outputAfter.syscalls - outputBefore.syscalls;
+                frameOutput.bytes = outputAfter.bytes - outputBefore.bytes;
+                loopOutput.syscalls += frameOutput.syscalls;
+                loopOutput.bytes += frameOutput.bytes;
+                loopIterations++;
+                loopAllocations += AllocCounter::getCount() - allocationsBefore;
+            }
         }
     }
     TerminalHelper::disableAlternateBuffer();
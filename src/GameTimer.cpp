@@ -0,0 +1,45 @@
+/**
+ * @file GameTimer.cpp
+ * @brief Реализация планировщика гравитации на монотонных часах
+ */
+#include "GameTimer.h"
+#include <time.h>
+
+GameTimer::GameTimer() : intervalMicros(0), nextTick(0), running(false) {}
+
+int64_t GameTimer::nowMicros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+void GameTimer::start(int64_t interval) {
+    intervalMicros = interval > 0 ? interval : 1;
+    nextTick = nowMicros() + intervalMicros;
+    running = true;
+}
+
+void GameTimer::setInterval(int64_t interval) {
+    intervalMicros = interval > 0 ? interval : 1;
+}
+
+int GameTimer::consumeTicks(int64_t now, int maxTicks) {
+    if (!running || now < nextTick) {
+        return 0;
+    }
+    
+    int64_t due = (now - nextTick) / intervalMicros + 1;
+    if (due > maxTicks) {
+        nextTick = now + intervalMicros;
+        return maxTicks;
+    }
+    nextTick += due * intervalMicros;
+    return static_cast<int>(due);
+}
+
+int64_t GameTimer::getTimeUntilNextTick(int64_t now) const {
+    if (!running) {
+        return -1;
+    }
+    return nextTick > now ? nextTick - now : 0;
+}
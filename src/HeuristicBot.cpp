@@ -0,0 +1,144 @@
+/**
+ * @file HeuristicBot.cpp
+ * @brief Реализация бота, оценивающего положения фигуры по признакам поля
+ */
+#include "HeuristicBot.h"
+#include <algorithm>
+
+namespace {
+
+constexpr float OUTSIDE_TARGET_PENALTY = 1000.0f; /**< Штраф за клетку вне картинки */
+
+/**
+ * @brief Считает клетки фигуры вне целевой области картинки
+ */
+int countOutsideTarget(const Field& field, const Figure& figure) {
+    int outside = 0;
+    for (int i = 0; i < figure.getHeight(); i++) {
+        for (unsigned mask = figure.getRowMask(i); mask; mask &= mask - 1) {
+            int col = figure.getstartx() + __builtin_ctz(mask);
+            outside += field.isInTargetArea(figure.getstarty() + i, col) ? 0 : 1;
+        }
+    }
+    return outside;
+}
+
+}
+
+HeuristicBot::HeuristicBot(const BotWeights& botWeights) :
+    weights(botWeights),
+    generator(),
+    scratch(),
+    path()
+{
+    path.reserve(MoveGenerator::STATE_COUNT);
+    placementFeatures.reserve(MoveGenerator::ROTATIONS * BOARD_WIDTH * 2);
+    placementScores.reserve(MoveGenerator::ROTATIONS * BOARD_WIDTH * 2);
+    placementLines.reserve(MoveGenerator::ROTATIONS * BOARD_WIDTH * 2);
+    candidateRows.reserve(BOARD_HEIGHT * MoveGenerator::ROTATIONS * BOARD_WIDTH * 2);
+}
+
+float HeuristicBot::evaluate(const BoardFeatures& features) const {
+    return weights.aggregateHeight * features.aggregateHeight +
+           weights.holes * features.holes +
+           weights.bumpiness * features.bumpiness +
+           weights.linesCleared * features.linesCleared +
+           weights.wells * features.wells +
+           weights.rowTransitions * features.rowTransitions +
+           weights.columnTransitions * features.columnTransitions;
+}
+
+BoardFeatures HeuristicBot::measure(const Field& field) {
+    BoardFeatures features;
+    extractFeatures(field.getRows(), 1, FeatureShape(field), &features);
+    return features;
+}
+
+int HeuristicBot::placeCandidate(const Field& field, const Figure& figure, int index, int count) {
+    BoardRow* rows = candidateRows.data() + index;
+    int x = figure.getstartx();
+    int y = figure.getstarty();
+    bool clearsLines = field.getKind() != FIELD_PICTURE;
+    bool fillsRow = false;
+    for (int i = 0; i < figure.getHeight(); i++) {
+        unsigned mask = figure.getRowMask(i);
+        if (!mask) continue;
+        BoardRow shifted = (x >= 0) ? (BoardRow(mask) << x) : (BoardRow(mask) >> -x);
+        BoardRow& row = rows[(y + i) * count];
+        row |= shifted;
+        if (clearsLines && row == ~BoardRow(0)) {
+            fillsRow = true;
+        }
+    }
+    if (!fillsRow) {
+        return 0;
+    }
+
+    /** Линии очищает само поле: сжатие строк ведра повторять не нужно */
+    scratch = field;
+    Figure placed = figure;
+    scratch.placeFigure(placed);
+    int lines = scratch.clearFullLines();
+    const BoardRow* cleared = scratch.getRows();
+    for (int row = 0; row < BOARD_HEIGHT; row++) {
+        rows[row * count] = cleared[row];
+    }
+    return lines;
+}
+
+int HeuristicBot::evaluatePlacements(const Field& field, const Figure& figure) {
+    placementFeatures.clear();
+    placementScores.clear();
+    placementLines.clear();
+    int count = generator.generate(field, figure);
+    if (count == 0) {
+        return 0;
+    }
+    bool pictureMode = field.getKind() == FIELD_PICTURE;
+    const std::vector<Placement>& placements = generator.getPlacements();
+
+    /** Все положения начинают с копии поля, затем каждое добавляет свою фигуру */
+    const BoardRow* base = field.getRows();
+    candidateRows.resize(BOARD_HEIGHT * count);
+    for (int row = 0; row < BOARD_HEIGHT; row++) {
+        std::fill_n(candidateRows.begin() + row * count, count, base[row]);
+    }
+    for (int i = 0; i < count; i++) {
+        placementLines.push_back(placeCandidate(field, placements[i].figure, i, count));
+    }
+
+    placementFeatures.resize(count);
+    extractFeatures(candidateRows.data(), count, FeatureShape(field), placementFeatures.data());
+    for (int i = 0; i < count; i++) {
+        BoardFeatures& features = placementFeatures[i];
+        features.linesCleared = placementLines[i];
+        float score = evaluate(features);
+        if (pictureMode) {
+            score -= OUTSIDE_TARGET_PENALTY * countOutsideTarget(field, placements[i].figure);
+        }
+        placementScores.push_back(score);
+    }
+    return count;
+}
+
+const std::vector<EngineAction>& HeuristicBot::plan(const Field& field, const Figure& figure) {
+    path.clear();
+    int count = evaluatePlacements(field, figure);
+    if (count == 0) {
+        return path;
+    }
+    int best = 0;
+    for (int i = 1; i < count; i++) {
+        /** При равной оценке остается положение с более коротким путем */
+        if (placementScores[i] > placementScores[best]) {
+            best = i;
+        }
+    }
+    generator.getPath(generator.getPlacements()[best], path);
+    return path;
+}
+
+EngineAction HeuristicBot::nextAction(const Field& field, const Figure& figure) {
+    const std::vector<EngineAction>& actions = plan(field, figure);
+    return actions.empty() ? ACTION_HARD_DROP : actions.front();
+}
@@ -0,0 +1,198 @@
+/**
+ * @file MoveGenerator.cpp
+ * @brief Реализация поиска достижимых положений фиксации фигуры
+ */
+#include "MoveGenerator.h"
+#include <algorithm>
+#include <cstring>
+
+constexpr int MoveGenerator::ROTATIONS;
+constexpr int MoveGenerator::STATE_COUNT;
+
+static_assert(MoveGenerator::STATE_COUNT <= 32767, "Номер состояния должен помещаться в int16_t");
+
+MoveGenerator::MoveGenerator() :
+    type(PIECE_NONE),
+    rotationCount(0),
+    parent(STATE_COUNT),
+    parentAction(STATE_COUNT),
+    depth(STATE_COUNT),
+    queue(STATE_COUNT)
+{
+    std::memset(shapes, 0, sizeof(shapes));
+    placements.reserve(ROTATIONS * BOARD_WIDTH * 2);
+}
+
+void MoveGenerator::prepareShapes(PieceType pieceType) {
+    type = pieceType;
+    /** Поворот O всегда возвращает состояние 0 (см. Figure::rotate) */
+    rotationCount = (pieceType == PIECE_O) ? 1 : ROTATIONS;
+    for (int rot = 0; rot < ROTATIONS; rot++) {
+        const PieceShape& shape = Figure::getShape(pieceType, rot);
+        ShapeInfo& info = shapes[rot];
+        unsigned columns = 0;
+        info.minRow = -1;
+        info.height = 0;
+        for (int i = 0; i < shape.size; i++) {
+            if (shape.rows[i]) {
+                if (info.minRow < 0) info.minRow = i;
+                info.height = i - info.minRow + 1;
+                columns |= shape.rows[i];
+            }
+        }
+        info.minCol = __builtin_ctz(columns);
+        info.width = 32 - __builtin_clz(columns) - info.minCol;
+        for (int i = 0; i < 4; i++) {
+            info.rows[i] = (i < info.height) ? (shape.rows[info.minRow + i] >> info.minCol) : 0;
+        }
+        info.canonical = rot;
+        for (int other = 0; other < rot; other++) {
+            if (std::equal(info.rows, info.rows + 4, shapes[other].rows)) {
+                info.canonical = other;
+                break;
+            }
+        }
+    }
+}
+
+void MoveGenerator::buildFreeBits(const Field& field) {
+    /**
+     * @algorithm
+     * Бит k строки t маски свободен, если клетки фигуры, поставленной
+     * левой верхней занятой клеткой в (t, k), не заняты. Для клетки
+     * (i, b) формы столбцы k, где она попадает на занятую клетку, - это
+     * строка битборда t + i, сдвинутая вправо на b; старшие b бит,
+     * вышедшие за слово, считаются занятыми
+     */
+    for (int rot = 0; rot < rotationCount; rot++) {
+        const ShapeInfo& info = shapes[rot];
+        int columns = BOARD_WIDTH - info.width + 1;
+        BoardRow range = (columns >= 64) ? ~BoardRow(0) : ((BoardRow(1) << columns) - 1);
+        for (int row = 0; row < BOARD_HEIGHT; row++) {
+            BoardRow blocked = 0;
+            for (int i = 0; i < info.height; i++) {
+                BoardRow bits = field.getRowBits(row + i);
+                for (unsigned mask = info.rows[i]; mask; mask &= mask - 1) {
+                    int b = __builtin_ctz(mask);
+                    blocked |= b ? ((bits >> b) | ~(~BoardRow(0) >> b)) : bits;
+                }
+            }
+            freeBits[rot][row] = ~blocked & range;
+        }
+    }
+}
+
+int MoveGenerator::getLandingRow(int rot, int row, int col) {
+    /**
+     * @note Как и LandingCache поля: если из строки from фигура долетает
+     *       до land, то из любой строки между ними - туда же
+     */
+    int from = landingFrom[rot][col];
+    int land = landingRow[rot][col];
+    if (from >= 0 && row >= from && row <= land) {
+        return land;
+    }
+    int stop = row;
+    while (isFree(rot, stop + 1, col)) {
+        stop++;
+        if (stop == from) {
+            stop = land;
+            break;
+        }
+    }
+    landingFrom[rot][col] = static_cast<int16_t>(row);
+    landingRow[rot][col] = static_cast<int16_t>(stop);
+    return stop;
+}
+
+void MoveGenerator::visit(int rot, int row, int col, int from, EngineAction action) {
+    BoardRow bit = BoardRow(1) << col;
+    if (visitedBits[rot][row] & bit) {
+        return;
+    }
+    visitedBits[rot][row] |= bit;
+    int state = encode(rot, row, col);
+    parent[state] = static_cast<int16_t>(from);
+    parentAction[state] = action;
+    depth[state] = (from < 0) ? 0 : static_cast<uint16_t>(depth[from] + 1);
+    queue.push_back(static_cast<int16_t>(state));
+}
+
+int MoveGenerator::generate(const Field& field, const Figure& figure) {
+    placements.clear();
+    queue.clear();
+    if (figure.getType() >= PIECE_COUNT) {
+        return 0;
+    }
+    if (figure.getType() != type) {
+        prepareShapes(figure.getType());
+    }
+    buildFreeBits(field);
+    std::memset(visitedBits, 0, sizeof(visitedBits));
+    std::memset(lockedBits, 0, sizeof(lockedBits));
+    std::memset(landingFrom, 0xff, sizeof(landingFrom));
+
+    int startRot = figure.getRotationState() % rotationCount;
+    int startRow = figure.getstarty() + shapes[startRot].minRow;
+    int startCol = figure.getstartx() + shapes[startRot].minCol;
+    if (!isFree(startRot, startRow, startCol)) {
+        return 0;
+    }
+    visit(startRot, startRow, startCol, -1, ACTION_HARD_DROP);
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        int state = queue[head];
+        int col = state % 64;
+        int row = (state / 64) % BOARD_HEIGHT;
+        int rot = state / (64 * BOARD_HEIGHT);
+        const ShapeInfo& info = shapes[rot];
+
+        int land = getLandingRow(rot, row, col);
+        BoardRow bit = BoardRow(1) << col;
+        if (!(lockedBits[info.canonical][land] & bit)) {
+            lockedBits[info.canonical][land] |= bit;
+            Placement placement;
+            placement.figure = Figure(type);
+            for (int i = 0; i < rot; i++) {
+                placement.figure.rotate();
+            }
+            placement.figure.setPosition(col - info.minCol, land - info.minRow);
+            placement.state = static_cast<int16_t>(state);
+            placement.pathLength = static_cast<uint16_t>(depth[state] + 1);
+            placements.push_back(placement);
+        }
+
+        /** Ходы повторяют TetrisEngine::step(): сдвиг вбок идет по диагонали вниз */
+        if (isFree(rot, row + 1, col - 1)) {
+            visit(rot, row + 1, col - 1, state, ACTION_LEFT);
+        }
+        if (isFree(rot, row + 1, col + 1)) {
+            visit(rot, row + 1, col + 1, state, ACTION_RIGHT);
+        }
+        if (rotationCount > 1) {
+            /** Поворот сохраняет угол рамки, а состояние задано первой занятой клеткой */
+            int next = (rot + 1) % ROTATIONS;
+            int nextRow = row - info.minRow + shapes[next].minRow;
+            int nextCol = col - info.minCol + shapes[next].minCol;
+            if (isFree(next, nextRow, nextCol)) {
+                if (isFree(next, nextRow + 1, nextCol)) {
+                    nextRow++;
+                }
+                visit(next, nextRow, nextCol, state, ACTION_ROTATE);
+            }
+        }
+        if (isFree(rot, row + 1, col)) {
+            visit(rot, row + 1, col, state, ACTION_SOFT_DROP);
+        }
+    }
+    return static_cast<int>(placements.size());
+}
+
+void MoveGenerator::getPath(const Placement& placement, std::vector<EngineAction>& path) const {
+    path.clear();
+    for (int state = placement.state; parent[state] >= 0; state = parent[state]) {
+        path.push_back(static_cast<EngineAction>(parentAction[state]));
+    }
+    std::reverse(path.begin(), path.end());
+    path.push_back(ACTION_HARD_DROP);
+}
@@ -0,0 +1,24 @@
+/**
+ * @file Palette.cpp
+ * @brief Реализация таблицы SGR-последовательностей палитры
+ */
+#include "Palette.h"
+
+namespace {
+const char* const SGR_TABLE[COLOR_COUNT] = {
+    "",          // COLOR_NONE
+    "\x1b[37m",  // COLOR_WALL
+    "\x1b[31m",  // COLOR_RED
+    "\x1b[32m",  // COLOR_GREEN
+    "\x1b[33m",  // COLOR_YELLOW
+    "\x1b[34m",  // COLOR_BLUE
+    "\x1b[35m",  // COLOR_MAGENTA
+    "\x1b[36m",  // COLOR_CYAN
+    "\x1b[37m",  // COLOR_WHITE
+    "\x1b[90m"   // COLOR_SHADOW
+};
+}
+
+const char* Palette::getSGR(uint8_t color) {
+    return color < COLOR_COUNT ? SGR_TABLE[color] : SGR_TABLE[COLOR_WALL];
+}
@@ -5,35 +5,33 @@
  * Содержит логику создания различных картинок и проверки их сборки.
  */
 #include "PictureField.h"
-#include <iostream>
 #include <algorithm>
-#include <cstdlib>
-#include <ctime>
-#include <unistd.h>
-#include "TerminalHelper.h"
 
 PictureField::PictureField() : PictureField(PICTURE_SQUARE) {}
 
 PictureField::PictureField(int type) 
-    : targetPicture(22 * 22, false),
-      currentPicture(22 * 22, false),
-      pictureColors(22 * 22, ""),
+    : currentPicture(BOARD_CELLS, false),
+      pictureColors(BOARD_CELLS, COLOR_NONE),
       currentPictureType(type),
-      gameOver(false) {
-    
-    for (int i = 0; i < 22; i++) {
-        setch(21, i, true, " ");
-        setch(i, 0, true, " ");
-        setch(i, 21, true, " ");
+      gameOver(false),
+      touchedBorder(false) {
+    kind = FIELD_PICTURE;
+    for (int i = 0; i < fieldWidth; i++) {
+        setch(BOARD_FLOOR_ROW, i, true, COLOR_WALL);
+    }
+    for (int i = 0; i < fieldHeight; i++) {
+        setch(i, 0, true, COLOR_WALL);
+        setch(i, BOARD_RIGHT_WALL, true, COLOR_WALL);
     }
+    captureWalls();
     loadPicture(type);
 }
 
 void PictureField::loadPicture(int type) {
     currentPictureType = type;
     
-    for (int i = 0; i < 22 * 22; i++) {
-        targetPicture[i] = false;
+    targetBits.assign(fieldHeight, 0);
+    for (int i = 0; i < BOARD_CELLS; i++) {
         currentPicture[i] = false;
     }
     
@@ -65,19 +63,17 @@ void PictureField::loadPicture(int type) {
 }
 
 void PictureField::drawSquare() {
-    for (int i = 0; i < 22 * 22; i++) {
-        targetPicture[i] = false;
-    }
+    targetBits.assign(fieldHeight, 0);
     
-    int squareWidth = 10;
-    int squareHeight = 10;
-    int startRow = 21 - squareHeight;
-    int startCol = 6;
+    int squareWidth = std::min(10, fieldWidth - 2);
+    int squareHeight = std::min(10, fieldHeight - 2);
+    int startRow = BOARD_FLOOR_ROW - squareHeight;
+    int startCol = (fieldWidth - squareWidth) / 2;
     
     for (int row = startRow; row < startRow + squareHeight; row++) {
         for (int col = startCol; col < startCol + squareWidth; col++) {
             if (isValidPosition(row, col)) {
-                targetPicture[row * 22 + col] = true;
+                targetBits[row] |= BoardRow(1) << col;
             }
         }
     }
@@ -104,16 +100,14 @@ void PictureField::drawStar() {
 }
 
 void PictureField::drawTriangle() {
-    for (int i = 0; i < 22 * 22; i++) {
-        targetPicture[i] = false;
-    }
+    targetBits.assign(fieldHeight, 0);
     
-    int triangleHeight = 16;
-    int triangleBase = 19;
+    int triangleHeight = fieldHeight - 6;
+    int triangleBase = fieldWidth - 3;
     
-    int floorRow = 20;
+    int floorRow = BOARD_FLOOR_ROW - 1;
     int startRow = floorRow - triangleHeight + 1;
-    int startCol = (22 - triangleBase) / 2;
+    int startCol = (fieldWidth - triangleBase) / 2;
     
     for (int row = 0; row < triangleHeight; row++) {
         int rowWidth = (row * triangleBase) / triangleHeight;
@@ -127,8 +121,8 @@ void PictureField::drawTriangle() {
             int fieldRow = startRow + row;
             int fieldCol = col;
             
-            if (fieldRow >= 0 && fieldRow < 22 && fieldCol >= 0 && fieldCol < 22) {
-                targetPicture[fieldRow * 22 + fieldCol] = true;
+            if (fieldRow >= 0 && fieldRow < fieldHeight && fieldCol >= 0 && fieldCol < fieldWidth) {
+                targetBits[fieldRow] |= BoardRow(1) << fieldCol;
             }
         }
     }
@@ -153,7 +147,6 @@ void PictureField::placeFigure(Figure& figure) {
     int x = figure.getstartx();
     int y = figure.getstarty();
     bool placedInTarget = false;
-    bool touchedBorder = false;
     
     for (int i = 0; i < figure.getHeight(); i++) {
         for (int j = 0; j < figure.getWidth(); j++) {
@@ -164,8 +157,8 @@ void PictureField::placeFigure(Figure& figure) {
                 if (isValidPosition(fieldy, fieldx)) {
                     if (isInTargetArea(fieldy, fieldx)) {
                         placedInTarget = true;
-                        currentPicture[fieldy * 22 + fieldx] = true;
-                        pictureColors[fieldy * 22 + fieldx] = figure.getcolor();
+                        currentPicture[fieldy * fieldWidth + fieldx] = true;
+                        pictureColors[fieldy * fieldWidth + fieldx] = figure.getcolor();
                         setch(fieldy, fieldx, true, figure.getcolor());
                     } else {
                         touchedBorder = true;
@@ -178,51 +171,26 @@ void PictureField::placeFigure(Figure& figure) {
         }
     }
     
-    if (placedInTarget) {
-        if (isPictureComplete()) {
-            TerminalHelper::moveCursorTo(27, 0);
-            TerminalHelper::clearCurrentLine();
-            std::cout << "\x1b[32m" << "ПОЗДРАВЛЯЕМ! Вы собрали картинку: " 
-                      << getPictureName() << "!" << "\x1b[0m";
-            std::cout.flush();
-            usleep(3000000);
-            gameOver = true;
-        }
-    }
-    
-    if (touchedBorder) {
-        TerminalHelper::moveCursorTo(27, 0);
-        TerminalHelper::clearCurrentLine();
-        std::cout << "\x1b[31m" << "ИГРА ОКОНЧЕНА! Часть фигуры вышла за границы картинки." << "\x1b[0m";
-        std::cout.flush();
-        usleep(3000000);
+    if ((placedInTarget && isPictureComplete()) || touchedBorder) {
         gameOver = true;
     }
 }
 
 void PictureField::resetGame() {
     gameOver = false;
-    for (int i = 0; i < 22 * 22; i++) {
+    touchedBorder = false;
+    for (int i = 0; i < BOARD_CELLS; i++) {
         currentPicture[i] = false;
-        pictureColors[i] = "";
+        pictureColors[i] = COLOR_NONE;
     }
 }
 
-bool PictureField::isValidPosition(int row, int col) {
-    return (row >= 0 && row < 22 && col >= 0 && col < 22);
-}
-
-bool PictureField::isInTargetArea(int row, int col) const {
-    if (row >= 0 && row < 22 && col >= 0 && col < 22) {
-        return targetPicture[row * 22 + col];
-    }
-    return false;
-}
-
 bool PictureField::isPictureComplete() const {
-    for (int i = 0; i < 22 * 22; i++) {
-        if (targetPicture[i] && !currentPicture[i]) {
-            return false;
+    for (int row = 0; row < fieldHeight; row++) {
+        for (BoardRow bits = targetBits[row]; bits; bits &= bits - 1) {
+            if (!currentPicture[row * fieldWidth + __builtin_ctzll(bits)]) {
+                return false;
+            }
         }
     }
     return true;
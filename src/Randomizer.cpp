@@ -0,0 +1,99 @@
+/**
+ * @file Randomizer.cpp
+ * @brief Реализация генератора xoshiro256** и алгоритмов выдачи фигур
+ */
+#include "Randomizer.h"
+
+constexpr int Randomizer::PREVIEW_SIZE;
+constexpr int Randomizer::HISTORY_SIZE;
+constexpr int Randomizer::HISTORY_ROLLS;
+
+void Xoshiro256::reseed(uint64_t seed) {
+    /** splitmix64 разносит даже соседние зерна по всему пространству состояний */
+    for (int i = 0; i < 4; i++) {
+        seed += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        state[i] = z ^ (z >> 31);
+    }
+}
+
+uint32_t Xoshiro256::nextBelow(uint32_t bound) {
+    uint64_t product = (next() >> 32) * bound;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < bound) {
+        uint32_t threshold = static_cast<uint32_t>(-bound) % bound;
+        while (low < threshold) {
+            product = (next() >> 32) * bound;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<uint32_t>(product >> 32);
+}
+
+Randomizer::Randomizer() : rng(), kind(RANDOMIZER_RANDOM), previewHead(0), bagPos(PIECE_COUNT) {
+    reset(0, RANDOMIZER_RANDOM);
+}
+
+void Randomizer::reset(uint64_t seed, RandomizerKind randomizerKind) {
+    rng.reseed(seed);
+    kind = randomizerKind < RANDOMIZER_COUNT ? randomizerKind : RANDOMIZER_RANDOM;
+    bagPos = PIECE_COUNT;
+    /** Начальная история как в TGM: S и Z реже выпадают первыми */
+    history[0] = PIECE_Z;
+    history[1] = PIECE_S;
+    history[2] = PIECE_S;
+    history[3] = PIECE_Z;
+    previewHead = 0;
+    for (int i = 0; i < PREVIEW_SIZE; i++) {
+        preview[i] = generate();
+    }
+}
+
+PieceType Randomizer::next() {
+    PieceType piece = preview[previewHead];
+    preview[previewHead] = generate();
+    previewHead = (previewHead + 1) % PREVIEW_SIZE;
+    return piece;
+}
+
+PieceType Randomizer::generate() {
+    switch (kind) {
+        case RANDOMIZER_BAG7:
+            if (bagPos == PIECE_COUNT) {
+                /** Перемешивание Фишера-Йетса */
+                for (int i = 0; i < PIECE_COUNT; i++) {
+                    bag[i] = static_cast<PieceType>(i);
+                }
+                for (int i = PIECE_COUNT - 1; i > 0; i--) {
+                    int j = static_cast<int>(rng.nextBelow(i + 1));
+                    PieceType t = bag[i];
+                    bag[i] = bag[j];
+                    bag[j] = t;
+                }
+                bagPos = 0;
+            }
+            return bag[bagPos++];
+        case RANDOMIZER_HISTORY: {
+            PieceType piece = PIECE_O;
+            for (int roll = 0; roll < HISTORY_ROLLS; roll++) {
+                piece = static_cast<PieceType>(rng.nextBelow(PIECE_COUNT));
+                bool seen = false;
+                for (int i = 0; i < HISTORY_SIZE; i++) {
+                    seen = seen || history[i] == piece;
+                }
+                if (!seen) {
+                    break;
+                }
+            }
+            for (int i = HISTORY_SIZE - 1; i > 0; i--) {
+                history[i] = history[i - 1];
+            }
+            history[0] = piece;
+            return piece;
+        }
+        default:
+            return static_cast<PieceType>(rng.nextBelow(PIECE_COUNT));
+    }
+}
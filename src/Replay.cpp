@@ -0,0 +1,193 @@
+/**
+ * @file Replay.cpp
+ * @brief Реализация записи, чтения и воспроизведения повторов партии
+ */
+#include "Replay.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+const char REPLAY_MAGIC[4] = {'T', 'T', 'R', 'P'}; /**< Сигнатура файла повтора */
+constexpr uint8_t REPLAY_VERSION = 1;              /**< Версия формата */
+constexpr uint64_t REPLAY_END = 7;                 /**< Код записи конца партии */
+constexpr size_t REPLAY_RESERVE = 64 * 1024;       /**< Буфер партии: запись не выделяет память в игре */
+
+/**
+ * @brief Чтение полей повтора с проверкой границ
+ */
+class ReplayCursor {
+private:
+    const std::vector<uint8_t>& data;
+    size_t position;
+    bool valid;
+
+public:
+    explicit ReplayCursor(const std::vector<uint8_t>& bytes) : data(bytes), position(0), valid(true) {}
+
+    bool isValid() const { return valid; }
+    bool atEnd() const { return position >= data.size(); }
+
+    uint8_t readByte() {
+        if (position >= data.size()) {
+            valid = false;
+            return 0;
+        }
+        return data[position++];
+    }
+
+    uint64_t readVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = readByte();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        valid = false;
+        return 0;
+    }
+
+    int readSigned() {
+        uint64_t value = readVarint();
+        return static_cast<int>(static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+    }
+};
+
+/**
+ * @brief Кодирует число со знаком для varint (zigzag)
+ */
+uint64_t zigzag(int value) {
+    int64_t wide = value;
+    return (static_cast<uint64_t>(wide) << 1) ^ static_cast<uint64_t>(wide >> 63);
+}
+
+}
+
+ReplayRecorder::ReplayRecorder() : buffer(), tick(0), lastTick(0), recording(false) {}
+
+void ReplayRecorder::start(const ReplayHeader& header) {
+    buffer.clear();
+    buffer.reserve(REPLAY_RESERVE);
+    buffer.insert(buffer.end(), REPLAY_MAGIC, REPLAY_MAGIC + sizeof(REPLAY_MAGIC));
+    buffer.push_back(REPLAY_VERSION);
+    buffer.push_back(static_cast<uint8_t>(header.mode));
+    buffer.push_back(static_cast<uint8_t>(header.pictureType));
+    buffer.push_back(static_cast<uint8_t>(header.randomizer));
+    buffer.push_back(static_cast<uint8_t>(header.boardWidth));
+    buffer.push_back(static_cast<uint8_t>(header.boardHeight));
+    appendVarint(header.seed);
+    appendVarint(header.settings.size());
+    for (size_t i = 0; i < header.settings.size(); i++) {
+        const std::string& name = header.settings[i].first;
+        size_t length = std::min<size_t>(name.size(), 255);
+        buffer.push_back(static_cast<uint8_t>(length));
+        buffer.insert(buffer.end(), name.begin(), name.begin() + length);
+        appendVarint(zigzag(header.settings[i].second));
+    }
+    tick = 0;
+    lastTick = 0;
+    recording = true;
+}
+
+bool ReplayRecorder::finish(const std::string& path, const TetrisEngine& engine) {
+    if (!recording) {
+        return false;
+    }
+    recording = false;
+    appendVarint(((tick - lastTick) << 3) | REPLAY_END);
+    appendVarint(static_cast<uint64_t>(std::max<int64_t>(engine.getScore(), 0)));
+    appendVarint(static_cast<uint64_t>(std::max(engine.getLinesCleared(), 0)));
+    appendVarint(static_cast<uint64_t>(std::max(engine.getPiecesLocked(), 0)));
+
+    /** Файл пишется под временным именем: оборванная запись не портит прежний повтор */
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary.c_str(), std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if (!file) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+bool readReplay(const std::string& path, ReplayHeader& header,
+                std::vector<ReplayEvent>& events, ReplayTotals& totals) {
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    ReplayCursor cursor(data);
+
+    for (size_t i = 0; i < sizeof(REPLAY_MAGIC); i++) {
+        if (cursor.readByte() != static_cast<uint8_t>(REPLAY_MAGIC[i])) {
+            return false;
+        }
+    }
+    if (cursor.readByte() != REPLAY_VERSION) {
+        return false;
+    }
+    uint8_t mode = cursor.readByte();
+    header.pictureType = cursor.readByte();
+    uint8_t randomizer = cursor.readByte();
+    header.boardWidth = cursor.readByte();
+    header.boardHeight = cursor.readByte();
+    header.seed = cursor.readVarint();
+    if (mode >= MODE_COUNT || randomizer >= RANDOMIZER_COUNT) {
+        return false;
+    }
+    header.mode = static_cast<GameMode>(mode);
+    header.randomizer = static_cast<RandomizerKind>(randomizer);
+
+    uint64_t settingCount = cursor.readVarint();
+    header.settings.clear();
+    for (uint64_t i = 0; i < settingCount && cursor.isValid(); i++) {
+        uint8_t length = cursor.readByte();
+        std::string name;
+        for (uint8_t k = 0; k < length; k++) {
+            name += static_cast<char>(cursor.readByte());
+        }
+        header.settings.push_back(std::make_pair(name, cursor.readSigned()));
+    }
+
+    events.clear();
+    totals = ReplayTotals();
+    uint64_t tick = 0;
+    while (cursor.isValid() && !cursor.atEnd()) {
+        uint64_t value = cursor.readVarint();
+        tick += value >> 3;
+        uint64_t code = value & 7;
+        if (code == REPLAY_END) {
+            totals.score = static_cast<int64_t>(cursor.readVarint());
+            totals.lines = static_cast<int>(cursor.readVarint());
+            totals.pieces = static_cast<int>(cursor.readVarint());
+            totals.present = cursor.isValid();
+            break;
+        }
+        ReplayEvent event;
+        event.tick = tick;
+        event.action = static_cast<EngineAction>(code);
+        events.push_back(event);
+    }
+    return cursor.isValid();
+}
+
+void playReplay(TetrisEngine& engine, const ReplayHeader& header, const std::vector<ReplayEvent>& events) {
+    engine.reset(header.seed, header.mode, header.randomizer);
+    uint64_t tick = 0;
+    for (size_t i = 0; i < events.size(); i++) {
+        /** Больше высоты поля за раз фигура не упадет: тики сверх нее ничего не меняют */
+        uint64_t ticks = events[i].tick - tick;
+        engine.applyGravity(static_cast<int>(std::min<uint64_t>(ticks, BOARD_HEIGHT)));
+        tick = events[i].tick;
+        engine.step(events[i].action);
+    }
+}
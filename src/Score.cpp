@@ -47,7 +47,7 @@ void GameScore::saveScores() {
     }
 }
 
-void GameScore::addScore(const std::string& name, int score) {
+void GameScore::addScore(const std::string& name, int64_t score) {
     /**
      * @brief Добавляет новый рекорд
      * @param name Имя игрока
@@ -39,6 +39,13 @@ void Settings::loadDefaultControls() {
     gameSettings["SCORE"] = 0;
     gameSettings["LINES_CLEARED"] = 0;
     gameSettings["GRAVITY_SPEED"] = 200000;
+    gameSettings["LOCK_DELAY"] = 500000;
+    gameSettings["AUTOPLAY_DELAY"] = 40000;
+    gameSettings["AUTOPLAY_DEPTH"] = 3;      // фигур в поиске бота (1 - без предпросмотра)
+    gameSettings["AUTOPLAY_BEAM"] = 16;      // ширина луча
+    gameSettings["AUTOPLAY_BUDGET"] = 20000; // время на фигуру, мкс
+    gameSettings["RANDOMIZER"] = 0;  // RandomizerKind: 0 - случайно, 1 - мешок из 7, 2 - история
+    gameSettings["REPLAY_RECORD"] = 0; // 1 - записывать повтор каждой партии (tetris_replay_<зерно>.ttr)
 }
 
 Settings* Settings::getInstance() {
@@ -158,10 +165,6 @@ void Settings::setSetting(const std::string& setting, int value) {
     saveSettings();
 }
 
-int Settings::getDropPointsForLevel(int level) {
-    return 50 * level;
-}
-
 int Settings::getSpeedForLevel(int level) {
     int baseSpeed = 200000;
     int minSpeed = 50000;
@@ -7,33 +7,59 @@
  */
 
 #include "TerminalHelper.h"
+#include "TerminalOutput.h"
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <cstdio>
 #include <iostream>
 #include <csignal>
+#include <cerrno>
 #include <cstring>
+#include <fcntl.h>
 
 bool TerminalHelper::terminalResized = false;
+int TerminalHelper::resizePipe[2] = {-1, -1};
+unsigned TerminalHelper::screenGeneration = 0;
+volatile bool TerminalHelper::sizeCached = false;
+int TerminalHelper::cachedRows = 0;
+int TerminalHelper::cachedCols = 0;
 
 void TerminalHelper::resizeHandler(int signo) {
     /**
      * @brief Обработчик сигнала SIGWINCH (изменение размера терминала)
      * @param signo Номер сигнала
-     * @note Устанавливает флаг terminalResized в true
-     *       Вызывается асинхронно при изменении размера окна
+     * @note Устанавливает флаг terminalResized в true и будит EventLoop
+     *       через self-pipe. Вызывается асинхронно при изменении размера окна
      */
     terminalResized = true;
+    sizeCached = false;
+    if (resizePipe[1] >= 0) {
+        int savedErrno = errno;
+        char byte = 1;
+        ssize_t written = write(resizePipe[1], &byte, 1);
+        (void)written;
+        errno = savedErrno;
+    }
 }
 
 bool TerminalHelper::getTerminalSize(int& rows, int& cols) {
-    struct winsize w;
-    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0) {
-        rows = w.ws_row;
-        cols = w.ws_col;
-        return true;
+    /**
+     * @note Размер запрашивается через ioctl() только после SIGWINCH,
+     *       иначе возвращается закэшированное значение
+     */
+    if (!sizeCached) {
+        sizeCached = true;
+        struct winsize w;
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) != 0) {
+            sizeCached = false;
+            return false;
+        }
+        cachedRows = w.ws_row;
+        cachedCols = w.ws_col;
     }
-    return false;
+    rows = cachedRows;
+    cols = cachedCols;
+    return true;
 }
 
 bool TerminalHelper::isTerminalSizeValid(int minRows, int minCols) {
@@ -45,27 +71,45 @@ bool TerminalHelper::isTerminalSizeValid(int minRows, int minCols) {
 }
 
 void TerminalHelper::clearScreen() {
-    printf("\033[2J\033[1;1H");
-    fflush(stdout);
+    TerminalOutput::write("\033[2J\033[1;1H");
+    screenGeneration++;
+}
+
+unsigned TerminalHelper::getScreenGeneration() {
+    return screenGeneration;
 }
 
 void TerminalHelper::moveCursorTo(int row, int col) {
-    printf("\033[%d;%dH", row + 1, col + 1);
-    fflush(stdout);
+    TerminalOutput::writef("\033[%d;%dH", row + 1, col + 1);
 }
 
 void TerminalHelper::moveCursorToSafePosition() {
     int rows, cols;
     if (getTerminalSize(rows, cols)) {
-        printf("\033[%d;1H", rows);
-        fflush(stdout);
+        TerminalOutput::writef("\033[%d;1H", rows);
     }
 }
 
 void TerminalHelper::initResizeHandler() {
+    if (resizePipe[0] < 0 && pipe(resizePipe) == 0) {
+        for (int i = 0; i < 2; i++) {
+            fcntl(resizePipe[i], F_SETFL, fcntl(resizePipe[i], F_GETFL) | O_NONBLOCK);
+            fcntl(resizePipe[i], F_SETFD, FD_CLOEXEC);
+        }
+    }
     signal(SIGWINCH, resizeHandler);
 }
 
+int TerminalHelper::getResizeFd() {
+    return resizePipe[0];
+}
+
+void TerminalHelper::drainResizeFd() {
+    char buffer[64];
+    while (resizePipe[0] >= 0 && read(resizePipe[0], buffer, sizeof(buffer)) > 0) {
+    }
+}
+
 bool TerminalHelper::wasResized() {
     bool resized = terminalResized;
     terminalResized = false;
@@ -77,67 +121,58 @@ void TerminalHelper::getCurrentSize(int& rows, int& cols) {
 }
 
 void TerminalHelper::saveScreen() {
-    printf("\033[?1049h");
-    fflush(stdout);
+    TerminalOutput::write("\033[?1049h");
+    screenGeneration++;
 }
 
 void TerminalHelper::restoreScreen() {
-    printf("\033[?1049l");
-    fflush(stdout);
+    TerminalOutput::write("\033[?1049l");
+    screenGeneration++;
 }
 
 void TerminalHelper::clearCurrentLine() {
-    printf("\033[2K");
-    fflush(stdout);
+    TerminalOutput::write("\033[2K");
 }
 
 void TerminalHelper::enableAlternateBuffer() {
-    printf("\033[?1049h\033[H");
-    fflush(stdout);
+    TerminalOutput::write("\033[?1049h\033[H");
+    screenGeneration++;
 }
 
 void TerminalHelper::disableAlternateBuffer() {
-    printf("\033[?1049l");
-    fflush(stdout);
+    TerminalOutput::write("\033[?1049l");
+    screenGeneration++;
 }
 
 void TerminalHelper::disableScrolling() {
-    printf("\033[?7l");
-    printf("\033[r");
-    fflush(stdout);
+    TerminalOutput::write("\033[?7l");
+    TerminalOutput::write("\033[r");
 }
 
 void TerminalHelper::enableScrolling() {
-    printf("\033[?7h");
-    fflush(stdout);
+    TerminalOutput::write("\033[?7h");
 }
 
 void TerminalHelper::setScrollRegion(int top, int bottom) {
-    printf("\033[%d;%dr", top, bottom);
-    fflush(stdout);
+    TerminalOutput::writef("\033[%d;%dr", top, bottom);
 }
 
 void TerminalHelper::clearScrollRegion() {
-    printf("\033[r");
-    fflush(stdout);
+    TerminalOutput::write("\033[r");
 }
 
 void TerminalHelper::saveCursor() {
-    printf("\033[s");
-    fflush(stdout);
+    TerminalOutput::write("\033[s");
 }
 
 void TerminalHelper::restoreCursor() {
-    printf("\033[u");
-    fflush(stdout);
+    TerminalOutput::write("\033[u");
 }
 
 void TerminalHelper::hideCursor() {
-    printf("\033[?25l");
-    fflush(stdout);
+    TerminalOutput::write("\033[?25l");
 }
 
 void TerminalHelper::showCursor() {
-    printf("\033[?25h");
-    fflush(stdout);
+    TerminalOutput::write("\033[?25h");
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
  * Настраивает raw-режим терминала для чтения одиночных символов.
  */
 #include "TerminalInput.h"
+#include "TerminalOutput.h"
 #include <unistd.h>
 #include <termios.h>
 #include <stdio.h>
@@ -38,7 +39,9 @@ char TerminalInput::getInput() {
      * @return Прочитанный символ или 0 при ошибке
      * @note Использует системный вызов read()
      *       Не блокирует выполнение если нет данных
+     *       Перед чтением сбрасывает накопленный вывод на экран
      */
+    TerminalOutput::flush();
     char c = 0;
     if (read(STDIN_FILENO, &c, 1) != 1) {
         return 0;
@@ -0,0 +1,125 @@
+/**
+ * @file TerminalOutput.cpp
+ * @brief Реализация буфера вывода в терминал с выводом одним write()
+ */
+#include "TerminalOutput.h"
+#include <unistd.h>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+
+namespace {
+const size_t BUFFER_SIZE = 64 * 1024;
+
+char buffer[BUFFER_SIZE];
+size_t used = 0;
+OutputCounters counters = {0, 0};
+
+void writeAll(const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t written = ::write(STDOUT_FILENO, data, length);
+        counters.syscalls++;
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        counters.bytes += written;
+        data += written;
+        length -= written;
+    }
+}
+
+/**
+ * @brief streambuf без собственного буфера, пишущий в TerminalOutput
+ */
+class OutputStreamBuf : public std::streambuf {
+protected:
+    int_type overflow(int_type c) override {
+        if (c != traits_type::eof()) {
+            char ch = traits_type::to_char_type(c);
+            TerminalOutput::write(&ch, 1);
+        }
+        return traits_type::not_eof(c);
+    }
+    
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        TerminalOutput::write(s, n);
+        return n;
+    }
+    
+    int sync() override {
+        TerminalOutput::flush();
+        return 0;
+    }
+};
+
+OutputStreamBuf streamBuf;
+std::streambuf* originalCoutBuf = nullptr;
+}
+
+void TerminalOutput::install() {
+    if (!originalCoutBuf) {
+        std::cout.flush();
+        originalCoutBuf = std::cout.rdbuf(&streamBuf);
+    }
+}
+
+void TerminalOutput::uninstall() {
+    if (originalCoutBuf) {
+        flush();
+        std::cout.rdbuf(originalCoutBuf);
+        originalCoutBuf = nullptr;
+    }
+}
+
+void TerminalOutput::write(const char* data, size_t length) {
+    if (used + length > BUFFER_SIZE) {
+        flush();
+        if (length > BUFFER_SIZE) {
+            writeAll(data, length);
+            return;
+        }
+    }
+    memcpy(buffer + used, data, length);
+    used += length;
+}
+
+void TerminalOutput::write(const char* text) {
+    write(text, strlen(text));
+}
+
+void TerminalOutput::writef(const char* format, ...) {
+    char line[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (length > 0) {
+        write(line, length < (int)sizeof(line) ? length : sizeof(line) - 1);
+    }
+}
+
+void TerminalOutput::flush() {
+    if (used == 0) {
+        return;
+    }
+    writeAll(buffer, used);
+    used = 0;
+}
+
+OutputCounters TerminalOutput::getCounters() {
+    return counters;
+}
+
+bool TerminalOutput::isStatsEnabled() {
+#ifdef TETRIS_OUTPUT_STATS
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,209 @@
+/**
+ * @file TetrisEngine.cpp
+ * @brief Реализация игровых правил без ввода-вывода
+ *
+ * Содержит движение фигуры, фиксацию, очистку линий, подсчет очков
+ * и смену уровня. Отображение и тайминги остаются в GameController.
+ */
+#include "TetrisEngine.h"
+#include "PictureField.h"
+#include <algorithm>
+
+TetrisEngine::TetrisEngine() :
+    field(nullptr),
+    figure(),
+    mode(MODE_CLASSIC),
+    randomizer(),
+    score(0),
+    level(1),
+    linesClearedTotal(0),
+    piecesLocked(0),
+    gameOver(false)
+{
+}
+
+TetrisEngine::~TetrisEngine() {
+    delete field;
+}
+
+void TetrisEngine::reset(uint64_t seed, GameMode gameMode, RandomizerKind randomizerKind) {
+    delete field;
+    switch (gameMode) {
+        case MODE_BUCKET:
+            field = new BucketField();
+            break;
+        case MODE_PICTURE_SQUARE:
+            field = new PictureField(PICTURE_SQUARE);
+            break;
+        case MODE_PICTURE_TRIANGLE:
+            field = new PictureField(PICTURE_TRIANGLE);
+            break;
+        default:
+            gameMode = MODE_CLASSIC;
+            field = new Field();
+    }
+    mode = gameMode;
+    randomizer.reset(seed, randomizerKind);
+    score = 0;
+    level = 1;
+    linesClearedTotal = 0;
+    piecesLocked = 0;
+    gameOver = false;
+    spawn(FigureO());
+}
+
+int TetrisEngine::getDropPointsForLevel(int level) {
+    return 50 * level;
+}
+
+int TetrisEngine::getLinePointsForLevel(int lines, int level) {
+    int points = 0;
+    switch (lines) {
+        case 1: points = 100; break;
+        case 2: points = 300; break;
+        case 3: points = 500; break;
+        case 4: points = 800; break;
+    }
+    return points * level;
+}
+
+bool TetrisEngine::canMove(int dx, int dy) const {
+    return !field->collides(figure, figure.getstartx() + dx, figure.getstarty() + dy);
+}
+
+bool TetrisEngine::canRotate() const {
+    /**
+     * @note Проверяет ту же позицию, в которую фигура попадет после rotate()
+     */
+    Figure testFigure = figure;
+    testFigure.rotate();
+    return !field->collides(testFigure, testFigure.getstartx(), testFigure.getstarty());
+}
+
+bool TetrisEngine::isGrounded() const {
+    return field->getDropDistance(figure) == 0;
+}
+
+int TetrisEngine::applyGravity(int rows) {
+    if (!field || gameOver || rows <= 0) {
+        return 0;
+    }
+    int fall = std::min(rows, field->getDropDistance(figure));
+    if (fall > 0) {
+        figure.setPosition(figure.getstartx(), figure.getstarty() + fall);
+    }
+    return fall;
+}
+
+StepResult TetrisEngine::step(EngineAction action) {
+    StepResult result = StepResult();
+    if (!field || gameOver) {
+        result.gameOver = gameOver;
+        return result;
+    }
+
+    switch (action) {
+        case ACTION_LEFT:
+        case ACTION_RIGHT: {
+            int dx = (action == ACTION_LEFT) ? -1 : 1;
+            if (canMove(dx, 1)) {
+                figure.setPosition(figure.getstartx() + dx, figure.getstarty() + 1);
+                result.moved = true;
+            }
+            break;
+        }
+        case ACTION_SOFT_DROP:
+            if (canMove(0, 1)) {
+                figure.setPosition(figure.getstartx(), figure.getstarty() + 1);
+                result.moved = true;
+                result.scoreDelta = 40 * level;
+                score += result.scoreDelta;
+            }
+            break;
+        case ACTION_HARD_DROP:
+            result.dropDistance = field->getDropDistance(figure);
+            if (result.dropDistance > 0) {
+                figure.setPosition(figure.getstartx(), figure.getstarty() + result.dropDistance);
+                result.moved = true;
+                result.dropPoints = getDropPointsForLevel(level) * result.dropDistance;
+                result.scoreDelta = result.dropPoints;
+                score += result.dropPoints;
+            }
+            lockFigure(result);
+            break;
+        case ACTION_ROTATE:
+            if (canRotate()) {
+                figure.rotate();
+                if (canMove(0, 1)) {
+                    figure.setPosition(figure.getstartx(), figure.getstarty() + 1);
+                }
+                result.moved = true;
+            }
+            break;
+        case ACTION_GRAVITY:
+            result.moved = applyGravity(1) > 0;
+            break;
+        case ACTION_LOCK:
+            lockFigure(result);
+            break;
+        default:
+            break;
+    }
+    result.gameOver = gameOver;
+    return result;
+}
+
+void TetrisEngine::lockFigure(StepResult& result) {
+    /**
+     * @brief Фиксация фигуры
+     * @algorithm
+     * 1. Фигура, которая еще может опуститься, не фиксируется
+     * 2. Фигура записывается в поле; в режиме картинки проверяется картинка
+     * 3. Иначе очищаются линии, начисляются очки и повышается уровень
+     * 4. Появляется следующая фигура; если ей нет места, партия окончена
+     */
+    if (canMove(0, 1)) {
+        return;
+    }
+
+    field->placeFigure(figure);
+    result.locked = true;
+    result.lockedFigure = figure;
+    piecesLocked++;
+
+    if (isPictureMode()) {
+        PictureField* pictureField = asPictureField(field);
+        result.pictureComplete = pictureField->isPictureComplete();
+        result.pictureBroken = pictureField->hasTouchedBorder();
+        if (pictureField->isGameOver()) {
+            gameOver = true;
+            return;
+        }
+    } else {
+        result.linesCleared = field->clearFullLines();
+        if (result.linesCleared > 0) {
+            linesClearedTotal += result.linesCleared;
+            result.linePoints = getLinePointsForLevel(result.linesCleared, level);
+            result.scoreDelta += result.linePoints;
+            score += result.linePoints;
+            if (linesClearedTotal >= level * 10) {
+                level++;
+                result.levelUp = true;
+            }
+        }
+    }
+
+    spawn(Figure(randomizer.next()));
+    if (!canMove(0, 0)) {
+        gameOver = true;
+    }
+}
+
+void TetrisEngine::spawn(const Figure& next) {
+    figure = next;
+    if (isPictureMode()) {
+        figure.setPosition((field->getWidth() - figure.getWidth()) / 2, SPAWN_Y);
+    } else {
+        figure.setPosition(SPAWN_X, SPAWN_Y);
+    }
+}
@@ -0,0 +1,100 @@
+/**
+ * @file ThreadPool.cpp
+ * @brief Реализация пула потоков с перехватом задач
+ */
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned threadCount) : pending(0), nextQueue(0), stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threadCount; i++) {
+        queues.push_back(new WorkQueue());
+    }
+    for (unsigned i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    for (size_t i = 0; i < queues.size(); i++) {
+        delete queues[i];
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    WorkQueue* queue = queues[nextQueue.fetch_add(1) % queues.size()];
+    pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        queue->tasks.push_back(std::move(task));
+    }
+    /** Захват stateMutex не дает потоку уснуть между проверкой очередей и ожиданием */
+    std::lock_guard<std::mutex> lock(stateMutex);
+    taskReady.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(stateMutex);
+    allDone.wait(lock, [this] { return pending.load() == 0; });
+}
+
+bool ThreadPool::takeTask(unsigned index, std::function<void()>& task) {
+    {
+        WorkQueue* own = queues[index];
+        std::lock_guard<std::mutex> lock(own->mutex);
+        if (!own->tasks.empty()) {
+            task = std::move(own->tasks.back());
+            own->tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < queues.size(); offset++) {
+        WorkQueue* victim = queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->tasks.empty()) {
+            task = std::move(victim->tasks.front());
+            victim->tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::workerLoop(unsigned index) {
+    std::function<void()> task;
+    while (true) {
+        if (takeTask(index, task)) {
+            task();
+            task = nullptr;
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(stateMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(stateMutex);
+        if (stopping) {
+            return;
+        }
+        /** Задача могла появиться после takeTask: ждем только если все очереди пусты */
+        bool empty = true;
+        for (size_t i = 0; i < queues.size() && empty; i++) {
+            std::lock_guard<std::mutex> queueLock(queues[i]->mutex);
+            empty = queues[i]->tasks.empty();
+        }
+        if (empty) {
+            taskReady.wait(lock);
+        }
+    }
+}
@@ -98,22 +98,23 @@ int main(int argc, char* argv[]) {
     /**
      * @section random_seed Инициализация генератора случайных чисел
      * 
-     * Генератор случайных чисел инициализируется одним из двух способов:
+     * Зерно выбирается одним из двух способов:
      * 1. Если передан аргумент командной строки: используется как seed
      * 2. Если аргументов нет: используется текущее время (time(NULL))
      * 
-     * Это обеспечивает либо воспроизводимость (с фиксированным seed), либо
-     * случайность (с seed от времени) в разных игровых сессиях.
+     * Зерно передается в GameController; каждая партия получает свой
+     * генератор фигур (Randomizer), не зависящий от rand() и libc.
      */
+    uint64_t seed;
     if (argc > 1) {
-        int seed = std::atoi(argv[1]);
-        srand(seed);
-        std::cout << "Используется seed: " << seed << std::endl;
+        int argSeed = std::atoi(argv[1]);
+        seed = static_cast<uint64_t>(argSeed);
+        std::cout << "Используется seed: " << argSeed << std::endl;
     } else {
-        srand(time(NULL));
+        seed = static_cast<uint64_t>(time(NULL));
     }
     
-    GameController controller;    
+    GameController controller(seed);    
     controller.run();
     
     return 0;
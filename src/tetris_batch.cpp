@@ -0,0 +1,95 @@
+/**
+ * @file tetris_batch.cpp
+ * @brief Реализация C-интерфейса tetris_batch поверх BatchEnv
+ */
+#include "tetris_batch.h"
+#include "BatchEnv.h"
+#include <cstddef>
+#include <new>
+
+static_assert(TETRIS_BATCH_MODE_CLASSIC == MODE_CLASSIC && TETRIS_BATCH_MODE_BUCKET == MODE_BUCKET,
+              "Режимы C-интерфейса должны совпадать с GameMode");
+static_assert(TETRIS_BATCH_RANDOMIZER_RANDOM == RANDOMIZER_RANDOM &&
+              TETRIS_BATCH_RANDOMIZER_BAG == RANDOMIZER_BAG7 &&
+              TETRIS_BATCH_RANDOMIZER_HISTORY == RANDOMIZER_HISTORY,
+              "Алгоритмы выдачи C-интерфейса должны совпадать с RandomizerKind");
+static_assert(TETRIS_BATCH_ACTION_LEFT == ACTION_LEFT && TETRIS_BATCH_ACTION_RIGHT == ACTION_RIGHT &&
+              TETRIS_BATCH_ACTION_SOFT_DROP == ACTION_SOFT_DROP &&
+              TETRIS_BATCH_ACTION_HARD_DROP == ACTION_HARD_DROP &&
+              TETRIS_BATCH_ACTION_ROTATE == ACTION_ROTATE && TETRIS_BATCH_ACTION_GRAVITY == ACTION_GRAVITY &&
+              TETRIS_BATCH_ACTION_LOCK == ACTION_LOCK,
+              "Действия C-интерфейса должны совпадать с EngineAction");
+static_assert(sizeof(BoardRow) == sizeof(uint64_t), "Строка поля передается как uint64_t");
+static_assert(sizeof(BoardFeatures) == TETRIS_BATCH_FEATURE_COUNT * sizeof(int32_t) &&
+              offsetof(BoardFeatures, holes) == TETRIS_BATCH_FEATURE_HOLES * sizeof(int32_t) &&
+              offsetof(BoardFeatures, linesCleared) == TETRIS_BATCH_FEATURE_LINES_CLEARED * sizeof(int32_t) &&
+              offsetof(BoardFeatures, columnTransitions) == TETRIS_BATCH_FEATURE_COLUMN_TRANSITIONS * sizeof(int32_t),
+              "Признаки передаются как массив int32_t в порядке BoardFeatures");
+
+struct TetrisBatch {
+    BatchEnv env;
+
+    TetrisBatch(int count, GameMode mode, RandomizerKind kind, bool allowSimd) :
+        env(count, mode, kind, allowSimd) {}
+};
+
+extern "C" {
+
+TetrisBatch* tetris_batch_create(int count, int mode, int randomizer, int flags) {
+    if (count <= 0 || (mode != MODE_CLASSIC && mode != MODE_BUCKET) ||
+        randomizer < 0 || randomizer >= RANDOMIZER_COUNT) {
+        return nullptr;
+    }
+    return new (std::nothrow) TetrisBatch(count, static_cast<GameMode>(mode),
+                                          static_cast<RandomizerKind>(randomizer),
+                                          (flags & TETRIS_BATCH_FLAG_NO_SIMD) == 0);
+}
+
+void tetris_batch_destroy(TetrisBatch* batch) {
+    delete batch;
+}
+
+void tetris_batch_reset(TetrisBatch* batch, uint64_t seed) {
+    batch->env.reset(seed);
+}
+
+void tetris_batch_reset_board(TetrisBatch* batch, int board, uint64_t seed) {
+    if (board >= 0 && board < batch->env.getBoardCount()) {
+        batch->env.resetBoard(board, seed);
+    }
+}
+
+void tetris_batch_step(TetrisBatch* batch, const uint8_t* actions) {
+    batch->env.step(actions);
+}
+
+int tetris_batch_count(const TetrisBatch* batch) { return batch->env.getBoardCount(); }
+int tetris_batch_board_width(void) { return BOARD_WIDTH; }
+int tetris_batch_board_height(void) { return BOARD_HEIGHT; }
+int tetris_batch_uses_simd(const TetrisBatch* batch) { return batch->env.isUsingSimd() ? 1 : 0; }
+
+const uint64_t* tetris_batch_rows(const TetrisBatch* batch) { return batch->env.getRows(); }
+const uint8_t* tetris_batch_piece_types(const TetrisBatch* batch) { return batch->env.getPieceTypes(); }
+const uint8_t* tetris_batch_rotations(const TetrisBatch* batch) { return batch->env.getRotations(); }
+const int16_t* tetris_batch_piece_x(const TetrisBatch* batch) { return batch->env.getPieceX(); }
+const int16_t* tetris_batch_piece_y(const TetrisBatch* batch) { return batch->env.getPieceY(); }
+const int64_t* tetris_batch_scores(const TetrisBatch* batch) { return batch->env.getScores(); }
+const int32_t* tetris_batch_levels(const TetrisBatch* batch) { return batch->env.getLevels(); }
+const int32_t* tetris_batch_lines(const TetrisBatch* batch) { return batch->env.getLines(); }
+const uint8_t* tetris_batch_game_over(const TetrisBatch* batch) { return batch->env.getGameOver(); }
+const int32_t* tetris_batch_rewards(const TetrisBatch* batch) { return batch->env.getRewards(); }
+const uint8_t* tetris_batch_lines_cleared(const TetrisBatch* batch) { return batch->env.getLinesCleared(); }
+const uint8_t* tetris_batch_locked(const TetrisBatch* batch) { return batch->env.getLocked(); }
+
+const int32_t* tetris_batch_features(TetrisBatch* batch) {
+    return reinterpret_cast<const int32_t*>(batch->env.computeFeatures());
+}
+
+int tetris_batch_next_piece(const TetrisBatch* batch, int board, int index) {
+    if (board < 0 || board >= batch->env.getBoardCount() || index < 0 || index >= Randomizer::PREVIEW_SIZE) {
+        return -1;
+    }
+    return batch->env.getNextPiece(board, index);
+}
+
+}
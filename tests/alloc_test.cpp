@@ -0,0 +1,166 @@
+/**
+ * @file alloc_test.cpp
+ * @brief Проверка: игровой цикл после разогрева не выделяет память
+ *
+ * Собирается с TETRIS_COUNT_ALLOCATIONS и повторяет работу одной итерации
+ * GameController::run без ввода и таймеров: копии Figure, шаги
+ * TetrisEngine::step, гравитацию через GameTimer::consumeTicks, фиксацию
+ * с выводом поля и вывод кадра через ConsoleView (сравнение буферов
+ * FrameBuffer и один write() на кадр). Вывод идет в псевдотерминал,
+ * чтобы ConsoleView видел терминал нужного размера.
+ *
+ * Первые партии - разогрев: буферы кадра и поля выделяются один раз.
+ * Затем считается AllocCounter::getCount() до и после каждой итерации;
+ * любое выделение - ошибка, программа завершается с кодом 1.
+ * Новая партия (TetrisEngine::reset) в счет не входит: она вне игрового цикла.
+ */
+#include "AllocCounter.h"
+#include "ConsoleView.h"
+#include "GameTimer.h"
+#include "TetrisEngine.h"
+#include "TerminalOutput.h"
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+constexpr int WARMUP_GAMES = 2;      /**< Партий разогрева */
+constexpr int MEASURED_GAMES = 20;   /**< Партий с подсчетом выделений */
+constexpr int64_t GRAVITY_MICROS = 1000; /**< Интервал гравитации в тестовом времени */
+
+int masterFd = -1;
+
+/**
+ * @brief Подменяет stdout ведомой стороной псевдотерминала 60x160
+ * @return false, если псевдотерминал не создан
+ */
+bool openTerminal() {
+    masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (masterFd < 0 || grantpt(masterFd) != 0 || unlockpt(masterFd) != 0) {
+        return false;
+    }
+    int slave = open(ptsname(masterFd), O_RDWR | O_NOCTTY);
+    if (slave < 0) {
+        return false;
+    }
+    struct winsize size = {};
+    size.ws_row = 60;
+    size.ws_col = 160;
+    if (ioctl(slave, TIOCSWINSZ, &size) != 0 || dup2(slave, STDOUT_FILENO) < 0) {
+        return false;
+    }
+    close(slave);
+    fcntl(masterFd, F_SETFL, fcntl(masterFd, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+/**
+ * @brief Читает вывод кадра из псевдотерминала, чтобы write() не блокировался
+ */
+void drainTerminal() {
+    char sink[4096];
+    while (read(masterFd, sink, sizeof(sink)) > 0) {
+    }
+}
+
+/**
+ * @brief Вывод фиксации, как GameController::showLockResult
+ */
+void showLock(ConsoleView& view, TetrisEngine& engine, const StepResult& result) {
+    if (!result.locked) {
+        return;
+    }
+    if (result.linesCleared == 0) {
+        view.ShowPlacedFigure(result.lockedFigure, *engine.getField());
+    } else {
+        view.ShowField(*engine.getField());
+        view.ShowGhostFigure(engine.getFigure(), *engine.getField());
+    }
+}
+
+/**
+ * @brief Одна итерация игрового цикла
+ * @param now Тестовое время, микросекунды
+ */
+void runIteration(ConsoleView& view, TetrisEngine& engine, GameTimer& gravity, int64_t now, uint32_t& rng) {
+    Field& field = *engine.getField();
+    Figure oldFigure = engine.getFigure();
+    int oldX = oldFigure.getstartx();
+    int oldY = oldFigure.getstarty();
+
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    EngineAction action = static_cast<EngineAction>(rng % (ACTION_ROTATE + 1));
+    if (action == ACTION_HARD_DROP && rng % 8) {
+        action = ACTION_SOFT_DROP;
+    }
+    StepResult result = engine.step(action);
+    if (result.moved && action != ACTION_SOFT_DROP) {
+        view.ClearGhostFigure(oldFigure, field);
+    }
+    showLock(view, engine, result);
+
+    engine.applyGravity(gravity.consumeTicks(now, field.getHeight()));
+    if (engine.isGrounded() && !engine.isGameOver()) {
+        showLock(view, engine, engine.step(ACTION_LOCK));
+    }
+
+    const Figure& figure = engine.getFigure();
+    view.ShowFigure(oldFigure, figure, field, oldX, oldY, figure.getstartx(), figure.getstarty());
+    TerminalOutput::flush();
+    drainTerminal();
+}
+
+}
+
+int main() {
+    if (!AllocCounter::isEnabled()) {
+        std::cerr << "Тест собран без TETRIS_COUNT_ALLOCATIONS" << std::endl;
+        return 1;
+    }
+    if (!openTerminal()) {
+        std::cerr << "Не удалось открыть псевдотерминал" << std::endl;
+        return 1;
+    }
+    TerminalOutput::install();
+
+    TetrisEngine engine;
+    ConsoleView view;
+    GameTimer gravity;
+    uint32_t rng = 2463534242u;
+    int64_t now = 0;
+    uint64_t iterations = 0;
+    uint64_t allocations = 0;
+    for (int game = 0; game < WARMUP_GAMES + MEASURED_GAMES; game++) {
+        engine.reset(static_cast<uint64_t>(game), MODE_CLASSIC, RANDOMIZER_BAG7);
+        gravity.start(GRAVITY_MICROS);
+        view.invalidate();
+        view.ShowField(*engine.getField());
+        TerminalOutput::flush();
+        drainTerminal();
+
+        bool measured = game >= WARMUP_GAMES;
+        while (!engine.isGameOver()) {
+            now += GRAVITY_MICROS / 2;
+            uint64_t before = AllocCounter::getCount();
+            runIteration(view, engine, gravity, now, rng);
+            if (measured) {
+                allocations += AllocCounter::getCount() - before;
+                iterations++;
+            }
+        }
+    }
+    TerminalOutput::uninstall();
+
+    /** Без вывода кадров тест не проверял бы ConsoleView и FrameBuffer */
+    OutputCounters output = TerminalOutput::getCounters();
+    std::cerr << "Выделений памяти в игровом цикле: " << allocations << " за " << iterations << " итераций, "
+              << output.bytes << " байт вывода" << std::endl;
+    return (allocations == 0 && iterations > 0 && output.bytes > 0) ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file batch_env_test.cpp
+ * @brief Проверка BatchEnv по TetrisEngine: случайные действия в пакете и в отдельных движках
+ *
+ * Для каждого режима (classic, bucket), алгоритма выдачи фигур и версии
+ * ядер (AVX2 и переносимой) пакет BatchEnv и по одному TetrisEngine на
+ * партию получают одни и те же действия. В четных партиях действия
+ * случайные, включая ACTION_GRAVITY, ACTION_LOCK и неизвестный код;
+ * нечетными играет HeuristicBot, чтобы проверялись очистка линий,
+ * очки за них и повышение уровня. После каждого шага сравниваются строки
+ * поля, фигура (тип, поворот, координаты), счет, линии, уровень,
+ * количество фигур, награда, очищенные линии, фиксация и конец партии.
+ * Оконченные партии начинаются заново с новым зерном в обоих.
+ *
+ * Количество партий не кратно четырем, чтобы проверялись и дорожки AVX2,
+ * и остаток после них.
+ */
+#include "BatchEnv.h"
+#include "HeuristicBot.h"
+#include "Randomizer.h"
+#include "TetrisEngine.h"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+constexpr int BOARD_COUNT = 37;       /**< Партий в пакете */
+constexpr int STEPS = 1500;           /**< Шагов на конфигурацию */
+constexpr uint8_t UNKNOWN_ACTION = 9; /**< Код вне EngineAction: пакет его пропускает */
+constexpr int MAX_REPORTS = 10;       /**< Сколько расхождений печатать */
+
+const char* const MODE_NAMES[] = {"classic", "bucket"};
+const char* const RANDOMIZER_NAMES[RANDOMIZER_COUNT] = {"random", "bag", "history"};
+
+/**
+ * @brief Случайное действие: чаще сдвиги, реже дроп, чтобы партии шли долго
+ */
+uint8_t randomAction(Xoshiro256& rng) {
+    uint32_t r = rng.nextBelow(100);
+    if (r < 30) return ACTION_LEFT;
+    if (r < 60) return ACTION_RIGHT;
+    if (r < 70) return ACTION_ROTATE;
+    if (r < 80) return ACTION_SOFT_DROP;
+    if (r < 88) return ACTION_GRAVITY;
+    if (r < 94) return ACTION_LOCK;
+    if (r < 99) return ACTION_HARD_DROP;
+    return UNKNOWN_ACTION;
+}
+
+/**
+ * @brief Сравнивает партию board пакета с движком
+ * @return Название первого различающегося поля или nullptr
+ */
+const char* compareBoard(const BatchEnv& env, int board, const TetrisEngine& engine,
+                         const StepResult& result, bool stepped) {
+    const Field& field = *engine.getField();
+    const Figure& figure = engine.getFigure();
+    for (int row = 0; row < BOARD_HEIGHT; row++) {
+        if (env.getRows()[row * BOARD_COUNT + board] != field.getRowBits(row)) return "строки поля";
+    }
+    if (env.getPieceTypes()[board] != figure.getType()) return "тип фигуры";
+    if (env.getRotations()[board] != figure.getRotationState()) return "поворот";
+    if (env.getPieceX()[board] != figure.getstartx()) return "X фигуры";
+    if (env.getPieceY()[board] != figure.getstarty()) return "Y фигуры";
+    if (env.getScores()[board] != engine.getScore()) return "счет";
+    if (env.getLines()[board] != engine.getLinesCleared()) return "линии";
+    if (env.getLevels()[board] != engine.getLevel()) return "уровень";
+    if (env.getPiecesLocked()[board] != engine.getPiecesLocked()) return "фигуры";
+    if ((env.getGameOver()[board] != 0) != engine.isGameOver()) return "конец партии";
+    if (env.getRewards()[board] != (stepped ? result.scoreDelta : 0)) return "награда";
+    if (env.getLinesCleared()[board] != (stepped ? result.linesCleared : 0)) return "очищено за шаг";
+    if ((env.getLocked()[board] != 0) != (stepped && result.locked)) return "фиксация";
+    return nullptr;
+}
+
+/**
+ * @brief Прогоняет одну конфигурацию
+ * @return Количество расхождений
+ */
+long runConfiguration(GameMode mode, RandomizerKind kind, bool allowSimd, long& checks, long& clearedLines) {
+    const uint64_t seed = 1000 + 100 * mode + 10 * kind;
+    BatchEnv env(BOARD_COUNT, mode, kind, allowSimd);
+    env.reset(seed);
+    std::vector<TetrisEngine> engines(BOARD_COUNT);
+    for (int b = 0; b < BOARD_COUNT; b++) {
+        engines[b].reset(seed + b, mode, kind);
+    }
+
+    Xoshiro256 rng(seed ^ (allowSimd ? 0x5eedULL : 0));
+    std::vector<uint8_t> actions(BOARD_COUNT);
+    HeuristicBot bot;
+    std::vector<std::vector<EngineAction> > paths(BOARD_COUNT);
+    std::vector<size_t> pathPositions(BOARD_COUNT, 0);
+    uint64_t nextSeed = seed + 100000;
+    long mismatches = 0;
+    for (int t = 0; t < STEPS; t++) {
+        for (int b = 0; b < BOARD_COUNT; b++) {
+            if (b % 2 == 0) {
+                actions[b] = randomAction(rng);
+                continue;
+            }
+            if (pathPositions[b] >= paths[b].size()) {
+                paths[b] = bot.plan(*engines[b].getField(), engines[b].getFigure());
+                pathPositions[b] = 0;
+                if (paths[b].empty()) {
+                    paths[b].push_back(ACTION_HARD_DROP);
+                }
+            }
+            actions[b] = paths[b][pathPositions[b]++];
+        }
+        env.step(actions.data());
+        for (int b = 0; b < BOARD_COUNT; b++) {
+            bool stepped = actions[b] < ACTION_COUNT;
+            StepResult result = StepResult();
+            if (stepped) {
+                result = engines[b].step(static_cast<EngineAction>(actions[b]));
+            }
+            const char* differs = compareBoard(env, b, engines[b], result, stepped);
+            checks++;
+            clearedLines += stepped ? result.linesCleared : 0;
+            if (differs) {
+                if (mismatches < MAX_REPORTS) {
+                    std::cout << MODE_NAMES[mode] << ", " << RANDOMIZER_NAMES[kind]
+                              << (env.isUsingSimd() ? ", AVX2" : ", переносимая")
+                              << ": шаг " << t << ", партия " << b << ", действие " << int(actions[b])
+                              << " - различается " << differs << std::endl;
+                }
+                mismatches++;
+            }
+            if (result.locked || engines[b].isGameOver()) {
+                pathPositions[b] = paths[b].size();
+            }
+            if (engines[b].isGameOver()) {
+                engines[b].reset(nextSeed, mode, kind);
+                env.resetBoard(b, nextSeed);
+                nextSeed++;
+            }
+        }
+    }
+    return mismatches;
+}
+
+}
+
+int main() {
+    long checks = 0;
+    long clearedLines = 0;
+    long mismatches = 0;
+    const GameMode modes[] = {MODE_CLASSIC, MODE_BUCKET};
+    for (GameMode mode : modes) {
+        for (int kind = 0; kind < RANDOMIZER_COUNT; kind++) {
+            for (int simd = 0; simd < 2; simd++) {
+                mismatches += runConfiguration(mode, static_cast<RandomizerKind>(kind), simd != 0, checks, clearedLines);
+            }
+        }
+    }
+    std::cout << "Проверок: " << checks << ", очищено линий: " << clearedLines
+              << ", расхождений: " << mismatches << std::endl;
+    /** Без очистки линий проверка не затронула бы сжатие строк и очки за линии */
+    return (mismatches == 0 && clearedLines > 0) ? 0 : 1;
+}
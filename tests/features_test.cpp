@@ -0,0 +1,161 @@
+/**
+ * @file features_test.cpp
+ * @brief Проверка признаков поля (extractFeatures) на полях с посчитанными вручную значениями
+ *
+ * Поля - классическое поле 22x22: игровые столбцы 1-20, строки 0-20,
+ * строка 21 - дно. Ожидаемые значения посчитаны по определениям
+ * BoardFeatures: высота столбца - от верхней занятой клетки до дна,
+ * сосед крайнего столбца - стенка высотой BOARD_HEIGHT (колодец у стенки
+ * считается, перепад со стенкой - нет), переходы вдоль строк учитывают
+ * стенки как занятые клетки, переходы вдоль столбцов - дно как занятое,
+ * а пространство над полем как пустое.
+ *
+ * Каждое поле проверяется отдельно (переносимая версия и версия с SIMD)
+ * и в пакете из нескольких полей, чтобы поля попали в разные дорожки
+ * AVX2 и в остаток после них.
+ */
+#include "BoardFeatures.h"
+#include "Field.h"
+
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#if TETRIS_BOARD_WIDTH == 22 && TETRIS_BOARD_HEIGHT == 22
+
+namespace {
+
+/**
+ * @brief Поле и ожидаемые признаки
+ */
+struct FeatureCase {
+    const char* name;
+    const char* stack[5];       /**< Нижние строки игровых столбцов 1-20, последняя - строка 20; '#' - занято */
+    BoardFeatures expected;     /**< aggregateHeight, holes, bumpiness, linesCleared, wells, rowTransitions, columnTransitions */
+};
+
+const FeatureCase CASES[] = {
+    {"пустое поле",
+     {nullptr},
+     {0, 0, 0, 0, 0, 42, 20}},
+    {"столбец высотой 3 у левой стенки",
+     {"#...................",
+      "#...................",
+      "#...................", nullptr},
+     {3, 0, 3, 0, 0, 42, 20}},
+    {"колодец глубиной 4 в столбце 10",
+     {"#########.##########",
+      "#########.##########",
+      "#########.##########",
+      "#########.##########", nullptr},
+     {76, 0, 8, 0, 4, 42, 20}},
+    {"колодец глубиной 4 у левой стенки",
+     {".###################",
+      ".###################",
+      ".###################",
+      ".###################", nullptr},
+     {76, 0, 4, 0, 4, 42, 20}},
+    {"колодец глубиной 2 у правой стенки",
+     {"###################.",
+      "###################.", nullptr},
+     {38, 0, 2, 0, 2, 42, 20}},
+    {"дыры под навесом и колодец глубиной 1",
+     {"....#...............",
+      "......#.............",
+      ".....##.............", nullptr},
+     {6, 2, 8, 0, 1, 48, 22}},
+};
+
+constexpr int CASE_COUNT = sizeof(CASES) / sizeof(CASES[0]);
+
+/**
+ * @brief Заполняет поле по строкам случая
+ */
+void fillField(Field& field, const FeatureCase& test) {
+    int rows = 0;
+    while (rows < 5 && test.stack[rows]) {
+        rows++;
+    }
+    for (int i = 0; i < rows; i++) {
+        int row = BOARD_FLOOR_ROW - rows + i;
+        for (int col = 0; col < BOARD_WIDTH - 2; col++) {
+            if (test.stack[i][col] == '#') {
+                field.setch(row, col + 1, true);
+            }
+        }
+    }
+}
+
+bool sameFeatures(const BoardFeatures& a, const BoardFeatures& b) {
+    return a.aggregateHeight == b.aggregateHeight && a.holes == b.holes && a.bumpiness == b.bumpiness &&
+           a.linesCleared == b.linesCleared && a.wells == b.wells && a.rowTransitions == b.rowTransitions &&
+           a.columnTransitions == b.columnTransitions;
+}
+
+void printFeatures(const BoardFeatures& f) {
+    std::cout << "высота " << f.aggregateHeight << ", дыры " << f.holes << ", перепады " << f.bumpiness
+              << ", колодцы " << f.wells << ", переходы строк " << f.rowTransitions
+              << ", переходы столбцов " << f.columnTransitions;
+}
+
+/**
+ * @brief Сравнивает признаки со значениями случая
+ * @param where Способ подсчета для сообщения
+ */
+bool check(const FeatureCase& test, const BoardFeatures& actual, const char* where) {
+    if (sameFeatures(actual, test.expected)) {
+        return true;
+    }
+    std::cout << test.name << " (" << where << "):\n  получено   ";
+    printFeatures(actual);
+    std::cout << "\n  ожидалось  ";
+    printFeatures(test.expected);
+    std::cout << std::endl;
+    return false;
+}
+
+}
+
+int main() {
+    std::vector<Field> fields(CASE_COUNT);
+    for (int i = 0; i < CASE_COUNT; i++) {
+        fillField(fields[i], CASES[i]);
+    }
+    FeatureShape shape(fields[0]);
+
+    int failures = 0;
+    for (int i = 0; i < CASE_COUNT; i++) {
+        BoardFeatures features;
+        extractFeatures(fields[i].getRows(), 1, shape, &features, false);
+        failures += !check(CASES[i], features, "переносимая версия");
+        extractFeatures(fields[i].getRows(), 1, shape, &features, true);
+        failures += !check(CASES[i], features, "SIMD");
+    }
+
+    /** Пакет: поле board - случай board % CASE_COUNT, раскладка BatchEnv */
+    const int count = 2 * CASE_COUNT + 1;
+    std::vector<BoardRow> rows(BOARD_HEIGHT * count);
+    for (int board = 0; board < count; board++) {
+        const BoardRow* source = fields[board % CASE_COUNT].getRows();
+        for (int row = 0; row < BOARD_HEIGHT; row++) {
+            rows[row * count + board] = source[row];
+        }
+    }
+    std::vector<BoardFeatures> batch(count);
+    extractFeatures(rows.data(), count, shape, batch.data(), true);
+    for (int board = 0; board < count; board++) {
+        failures += !check(CASES[board % CASE_COUNT], batch[board], "пакет");
+    }
+
+    std::cout << "Полей: " << CASE_COUNT << ", ошибок: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
+
+#else
+
+int main() {
+    std::cout << "Значения посчитаны для поля 22x22, проверка пропущена" << std::endl;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,82 @@
+/**
+ * @file replay_record.cpp
+ * @brief Записывает повторы партий бота для проверки tetris_replay
+ *
+ * Для каждого файла из командной строки играет партию HeuristicBot
+ * в очередном режиме (classic, bucket, square, triangle) и пишет ее
+ * ReplayRecorder, как GameController: тики гравитации между действиями,
+ * действия бота, фиксации. Проверка replay_roundtrip затем
+ * воспроизводит файлы tetris_replay и сверяет итоги.
+ *
+ * Пример:
+ * @code{.sh}
+ * ./tetris_replay_record classic.ttr bucket.ttr && ./tetris_replay classic.ttr bucket.ttr
+ * @endcode
+ */
+#include "HeuristicBot.h"
+#include "Replay.h"
+#include "TetrisEngine.h"
+
+#include <iostream>
+#include <vector>
+
+namespace {
+
+constexpr int MAX_PIECES = 500;    /**< Фигур в партии не больше */
+constexpr int GRAVITY_PERIOD = 3;  /**< Тик гравитации после каждого третьего действия */
+
+/**
+ * @brief Играет и записывает одну партию
+ * @return false, если файл не записан
+ */
+bool recordGame(const char* path, GameMode mode, uint64_t seed) {
+    TetrisEngine engine;
+    HeuristicBot bot;
+    ReplayRecorder recorder;
+    ReplayHeader header;
+    header.mode = mode;
+    header.seed = seed;
+    header.randomizer = RANDOMIZER_BAG7;
+    engine.reset(header.seed, header.mode, header.randomizer);
+    recorder.start(header);
+
+    int actions = 0;
+    while (!engine.isGameOver() && engine.getPiecesLocked() < MAX_PIECES) {
+        std::vector<EngineAction> path = bot.plan(*engine.getField(), engine.getFigure());
+        if (path.empty()) {
+            path.push_back(ACTION_HARD_DROP);
+        }
+        for (size_t i = 0; i < path.size() && !engine.isGameOver(); i++) {
+            if (++actions % GRAVITY_PERIOD == 0) {
+                engine.applyGravity(1);
+                recorder.addTicks(1);
+                /** Фигура на опоре фиксируется, как по задержке фиксации в игре */
+                if (engine.isGrounded()) {
+                    recorder.record(ACTION_LOCK);
+                    engine.step(ACTION_LOCK);
+                    break;
+                }
+            }
+            recorder.record(path[i]);
+            engine.step(path[i]);
+        }
+    }
+    std::cout << path << ": счет " << engine.getScore() << ", линии " << engine.getLinesCleared()
+              << ", фигуры " << engine.getPiecesLocked() << std::endl;
+    return recorder.finish(path, engine);
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Использование: " << argv[0] << " ФАЙЛ...\n";
+        return 1;
+    }
+    bool ok = true;
+    for (int i = 1; i < argc; i++) {
+        GameMode mode = static_cast<GameMode>((i - 1) % MODE_COUNT);
+        ok = recordGame(argv[i], mode, static_cast<uint64_t>(i)) && ok;
+    }
+    return ok ? 0 : 1;
+}
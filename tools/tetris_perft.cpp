@@ -0,0 +1,461 @@
+/**
+ * @file tetris_perft.cpp
+ * @brief Perft для генератора положений: счет узлов дерева фиксаций и проверка по эталону
+ *
+ * Как perft в шахматных движках: из заданного поля и последовательности
+ * фигур перебираются все достижимые положения фиксации (MoveGenerator)
+ * на глубину N. После каждой фиксации поле обновляется по правилам
+ * TetrisEngine: очистка линий, в режиме картинки - конец партии при выходе
+ * за картинку или при собранной картинке. Узлы - листья дерева, то есть
+ * число различных последовательностей из N фиксаций; на последнем уровне
+ * положения только считаются.
+ *
+ * Набор позиций фиксирован: пустое поле и поле с мусором для каждого
+ * варианта поля (Field, BucketField, PictureField). Для поля по умолчанию
+ * 22x22 и последовательности по умолчанию числа сверяются с записанными
+ * значениями - расхождение означает изменение столкновений, поворотов или
+ * генератора, и программа завершается с кодом 1.
+ *
+ * --verify дополнительно в каждом узле сравнивает положения MoveGenerator
+ * с простым поиском в ширину через Figure::rotate и Field::collides
+ * (те же правила, что TetrisEngine::step).
+ *
+ * Пример:
+ * @code{.sh}
+ * ./tetris_perft --depth 3
+ * ./tetris_perft --depth 2 --mode bucket --verify
+ * @endcode
+ */
+#include "Field.h"
+#include "MoveGenerator.h"
+#include "PictureField.h"
+#include "Randomizer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const DEFAULT_PIECES = "TLJSZIO";  /**< Последовательность фигур по умолчанию */
+constexpr int MAX_DEPTH = 16;                  /**< Предел глубины */
+
+/**
+ * @brief Вариант поля в наборе позиций
+ */
+enum PerftMode {
+    PERFT_CLASSIC,
+    PERFT_BUCKET,
+    PERFT_SQUARE,
+    PERFT_TRIANGLE,
+    PERFT_MODE_COUNT
+};
+
+const char* const MODE_NAMES[PERFT_MODE_COUNT] = { "classic", "bucket", "square", "triangle" };
+
+/**
+ * @brief Начальная позиция
+ */
+enum PerftPosition {
+    POSITION_EMPTY,    /**< Пустое поле */
+    POSITION_GARBAGE,  /**< Нижние строки заполнены с одной дырой, сверху неровная поверхность */
+    POSITION_COUNT
+};
+
+const char* const POSITION_NAMES[POSITION_COUNT] = { "empty", "garbage" };
+
+/**
+ * @brief Записанное значение perft
+ */
+struct ExpectedNodes {
+    PerftMode mode;
+    PerftPosition position;
+    int depth;
+    uint64_t nodes;
+};
+
+/**
+ * @brief Значения для поля 22x22 и последовательности DEFAULT_PIECES
+ */
+const ExpectedNodes EXPECTED[] = {
+    { PERFT_CLASSIC, POSITION_EMPTY, 1, 74 },
+    { PERFT_CLASSIC, POSITION_EMPTY, 2, 5542 },
+    { PERFT_CLASSIC, POSITION_EMPTY, 3, 419548 },
+    { PERFT_CLASSIC, POSITION_GARBAGE, 1, 73 },
+    { PERFT_CLASSIC, POSITION_GARBAGE, 2, 5364 },
+    { PERFT_CLASSIC, POSITION_GARBAGE, 3, 393811 },
+    { PERFT_BUCKET, POSITION_EMPTY, 1, 74 },
+    { PERFT_BUCKET, POSITION_EMPTY, 2, 5455 },
+    { PERFT_BUCKET, POSITION_EMPTY, 3, 396505 },
+    { PERFT_BUCKET, POSITION_GARBAGE, 1, 56 },
+    { PERFT_BUCKET, POSITION_GARBAGE, 2, 3052 },
+    { PERFT_BUCKET, POSITION_GARBAGE, 3, 161817 },
+    { PERFT_SQUARE, POSITION_EMPTY, 1, 74 },
+    { PERFT_SQUARE, POSITION_EMPTY, 2, 2550 },
+    { PERFT_SQUARE, POSITION_EMPTY, 3, 90314 },
+    { PERFT_SQUARE, POSITION_GARBAGE, 1, 73 },
+    { PERFT_SQUARE, POSITION_GARBAGE, 2, 2556 },
+    { PERFT_SQUARE, POSITION_GARBAGE, 3, 67137 },
+    { PERFT_TRIANGLE, POSITION_EMPTY, 1, 74 },
+    { PERFT_TRIANGLE, POSITION_EMPTY, 2, 4347 },
+    { PERFT_TRIANGLE, POSITION_EMPTY, 3, 248194 },
+    { PERFT_TRIANGLE, POSITION_GARBAGE, 1, 73 },
+    { PERFT_TRIANGLE, POSITION_GARBAGE, 2, 1952 },
+    { PERFT_TRIANGLE, POSITION_GARBAGE, 3, 46067 },
+};
+
+/**
+ * @brief Параметры запуска
+ */
+struct PerftOptions {
+    int depth = 3;
+    int mode = -1;       /**< Один вариант поля (-1 - все) */
+    int position = -1;   /**< Одна позиция (-1 - все) */
+    std::string pieces = DEFAULT_PIECES;
+    bool verify = false;
+};
+
+typedef std::array<int, 4> Cells;  /**< Клетки фигуры (строка * 64 + столбец), по возрастанию */
+
+Cells getCells(const Figure& figure) {
+    Cells cells = Cells();
+    int count = 0;
+    for (int i = 0; i < 4; i++) {
+        for (unsigned mask = figure.getRowMask(i); mask && count < 4; mask &= mask - 1) {
+            cells[count++] = (figure.getstarty() + i) * 64 + figure.getstartx() + __builtin_ctz(mask);
+        }
+    }
+    return cells;
+}
+
+/**
+ * @brief Простой поиск положений фиксации - эталон для MoveGenerator
+ * @note Ходы повторяют TetrisEngine::step(): сдвиг вбок - по диагонали
+ *       вниз, поворот опускает фигуру на строку, если есть место
+ */
+void findPlacementsNaive(const Field& field, const Figure& start, std::set<Cells>& result) {
+    result.clear();
+    if (field.collides(start, start.getstartx(), start.getstarty())) {
+        return;
+    }
+    const int margin = 4;
+    const int width = BOARD_WIDTH + 2 * margin;
+    const int height = BOARD_HEIGHT + 2 * margin;
+    std::vector<char> visited(4 * width * height, 0);
+    auto index = [&](const Figure& figure) {
+        return (figure.getRotationState() * height + figure.getstarty() + margin) * width +
+               figure.getstartx() + margin;
+    };
+    std::vector<Figure> queue(1, start);
+    visited[index(start)] = 1;
+    for (size_t head = 0; head < queue.size(); head++) {
+        Figure figure = queue[head];
+        Figure landed = figure;
+        landed.setPosition(figure.getstartx(), figure.getstarty() + field.getDropDistance(figure));
+        result.insert(getCells(landed));
+
+        Figure next[4];
+        int count = 0;
+        for (int dx = -1; dx <= 1; dx++) {
+            if (!field.collides(figure, figure.getstartx() + dx, figure.getstarty() + 1)) {
+                next[count] = figure;
+                next[count++].setPosition(figure.getstartx() + dx, figure.getstarty() + 1);
+            }
+        }
+        Figure rotated = figure;
+        rotated.rotate();
+        if (!field.collides(rotated, rotated.getstartx(), rotated.getstarty())) {
+            if (!field.collides(rotated, rotated.getstartx(), rotated.getstarty() + 1)) {
+                rotated.setPosition(rotated.getstartx(), rotated.getstarty() + 1);
+            }
+            next[count++] = rotated;
+        }
+        for (int i = 0; i < count; i++) {
+            int key = index(next[i]);
+            if (!visited[key]) {
+                visited[key] = 1;
+                queue.push_back(next[i]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Перебор дерева фиксаций для одного типа поля
+ * @tparam FieldType Field для classic и bucket, PictureField для картинки
+ *         (поле картинки копируется целиком, без срезки)
+ */
+template <typename FieldType>
+class PerftRunner {
+private:
+    const PerftOptions& options;
+    std::vector<FieldType> fields;              /**< Поле на каждом уровне */
+    std::vector<MoveGenerator> generators;      /**< Генератор на каждом уровне */
+    std::set<Cells> naive;                      /**< Положения эталонного поиска */
+    std::set<Cells> generated;                  /**< Положения генератора */
+    uint64_t mismatches;                        /**< Узлы, где генератор разошелся с эталоном */
+
+    Figure getPiece(int level) const {
+        static const char names[PIECE_COUNT + 1] = "OLTISZJ";
+        char name = options.pieces[level % options.pieces.size()];
+        Figure figure(static_cast<PieceType>(std::find(names, names + PIECE_COUNT, name) - names));
+        /** Точка появления как в TetrisEngine::spawn() */
+        if (fields[0].getKind() == FIELD_PICTURE) {
+            figure.setPosition((fields[0].getWidth() - figure.getWidth()) / 2, SPAWN_Y);
+        } else {
+            figure.setPosition(SPAWN_X, SPAWN_Y);
+        }
+        return figure;
+    }
+
+    void verify(int level, const Figure& piece, int count) {
+        findPlacementsNaive(fields[level], piece, naive);
+        generated.clear();
+        const std::vector<Placement>& placements = generators[level].getPlacements();
+        for (int i = 0; i < count; i++) {
+            generated.insert(getCells(placements[i].figure));
+        }
+        if (generated != naive || static_cast<size_t>(count) != generated.size()) {
+            mismatches++;
+        }
+    }
+
+    /**
+     * @brief Возвращает число листьев под полем уровня level
+     */
+    uint64_t search(int level, int depth) {
+        Figure piece = getPiece(level);
+        MoveGenerator& generator = generators[level];
+        int count = generator.generate(fields[level], piece);
+        if (options.verify) {
+            verify(level, piece, count);
+        }
+        if (depth == 1) {
+            return static_cast<uint64_t>(count);
+        }
+        uint64_t nodes = 0;
+        for (int i = 0; i < count; i++) {
+            FieldType& child = fields[level + 1];
+            child = fields[level];
+            Figure placed = generator.getPlacements()[i].figure;
+            child.placeFigure(placed);
+            if (!finishLock(child)) {
+                continue;
+            }
+            nodes += search(level + 1, depth - 1);
+        }
+        return nodes;
+    }
+
+    /**
+     * @brief Завершает фиксацию по правилам TetrisEngine
+     * @return false если партия окончена
+     */
+    static bool finishLock(Field& field) {
+        field.clearFullLines();
+        return true;
+    }
+
+    static bool finishLock(PictureField& field) {
+        return !field.isGameOver();
+    }
+
+public:
+    PerftRunner(const PerftOptions& perftOptions, const FieldType& root) :
+        options(perftOptions),
+        fields(perftOptions.depth + 1, root),
+        generators(perftOptions.depth + 1),
+        naive(),
+        generated(),
+        mismatches(0)
+    {
+    }
+
+    uint64_t run(int depth) {
+        return search(0, depth);
+    }
+
+    uint64_t getMismatches() const { return mismatches; }
+};
+
+/**
+ * @brief Заполняет мусором нижние игровые строки
+ * @note Зерно фиксировано: позиция одинакова в любой сборке с тем же размером поля
+ */
+void addGarbage(Field& field) {
+    Xoshiro256 rng(2024);
+    int filled = 0;
+    for (int row = BOARD_HEIGHT - 1; row >= 0 && filled < 8; row--) {
+        BoardRow valid = field.getValidBits(row);
+        if (!valid) {
+            continue;
+        }
+        int columns = __builtin_popcountll(valid);
+        int hole = static_cast<int>(rng.nextBelow(columns));
+        int index = 0;
+        for (BoardRow bits = valid; bits; bits &= bits - 1, index++) {
+            int col = __builtin_ctzll(bits);
+            /** Шесть строк с одной дырой, выше - неровная поверхность */
+            bool occupied = (filled < 6) ? (index != hole) : (rng.nextBelow(2) == 0);
+            if (occupied) {
+                field.setch(row, col, true, COLOR_WHITE);
+            }
+        }
+        filled++;
+    }
+}
+
+template <typename FieldType>
+uint64_t runPosition(const PerftOptions& options, PerftMode mode, PerftPosition position,
+                     FieldType& root, bool& ok) {
+    if (position == POSITION_GARBAGE) {
+        addGarbage(root);
+    }
+    bool checked = options.pieces == DEFAULT_PIECES && BOARD_WIDTH == 22 && BOARD_HEIGHT == 22;
+    uint64_t total = 0;
+    for (int depth = 1; depth <= options.depth; depth++) {
+        PerftRunner<FieldType> runner(options, root);
+        auto start = std::chrono::steady_clock::now();
+        uint64_t nodes = runner.run(depth);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        total += nodes;
+
+        std::cout << std::left << std::setw(10) << MODE_NAMES[mode] << std::setw(9) << POSITION_NAMES[position]
+                  << std::right << std::setw(3) << depth << std::setw(14) << nodes
+                  << std::fixed << std::setprecision(3) << std::setw(10) << seconds
+                  << std::setprecision(2) << std::setw(10) << nodes / std::max(seconds, 1e-9) / 1e6;
+        std::cout.unsetf(std::ios::floatfield);
+        if (checked) {
+            for (const ExpectedNodes& expected : EXPECTED) {
+                if (expected.mode == mode && expected.position == position && expected.depth == depth) {
+                    if (expected.nodes == nodes) {
+                        std::cout << "  ok";
+                    } else {
+                        std::cout << "  ОШИБКА: ожидалось " << expected.nodes;
+                        ok = false;
+                    }
+                }
+            }
+        }
+        if (options.verify) {
+            if (runner.getMismatches() == 0) {
+                std::cout << "  эталон ok";
+            } else {
+                std::cout << "  ОШИБКА: расхождений с эталоном " << runner.getMismatches();
+                ok = false;
+            }
+        }
+        std::cout << std::endl;
+    }
+    return total;
+}
+
+bool parseMode(const std::string& name, int& mode) {
+    for (int i = 0; i < PERFT_MODE_COUNT; i++) {
+        if (name == MODE_NAMES[i]) {
+            mode = i;
+            return true;
+        }
+    }
+    return name == "all" && (mode = -1, true);
+}
+
+bool parsePosition(const std::string& name, int& position) {
+    for (int i = 0; i < POSITION_COUNT; i++) {
+        if (name == POSITION_NAMES[i]) {
+            position = i;
+            return true;
+        }
+    }
+    return name == "all" && (position = -1, true);
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Использование: " << program << " [параметры]\n"
+              << "  --depth N         глубина (по умолчанию 3)\n"
+              << "  --mode M          all | classic | bucket | square | triangle\n"
+              << "  --position P      all | empty | garbage\n"
+              << "  --pieces S        последовательность фигур из O L T I S Z J (по умолчанию "
+              << DEFAULT_PIECES << ")\n"
+              << "  --verify          сверять каждый узел с простым поиском в ширину\n";
+}
+
+bool parseOptions(int argc, char* argv[], PerftOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--verify") {
+            options.verify = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--depth") {
+            options.depth = std::atoi(value.c_str());
+        } else if (arg == "--mode") {
+            if (!parseMode(value, options.mode)) return false;
+        } else if (arg == "--position") {
+            if (!parsePosition(value, options.position)) return false;
+        } else if (arg == "--pieces") {
+            options.pieces = value;
+        } else {
+            return false;
+        }
+    }
+    if (options.pieces.empty() ||
+        options.pieces.find_first_not_of("OLTISZJ") != std::string::npos) {
+        return false;
+    }
+    return options.depth >= 1 && options.depth <= MAX_DEPTH;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    PerftOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::cout << "Поле " << BOARD_WIDTH << "x" << BOARD_HEIGHT << ", фигуры " << options.pieces << "\n"
+              << "режим     позиция    N          узлы         с    Музл/с" << std::endl;
+
+    bool ok = true;
+    uint64_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int mode = 0; mode < PERFT_MODE_COUNT; mode++) {
+        if (options.mode >= 0 && options.mode != mode) continue;
+        for (int position = 0; position < POSITION_COUNT; position++) {
+            if (options.position >= 0 && options.position != position) continue;
+            PerftMode perftMode = static_cast<PerftMode>(mode);
+            PerftPosition perftPosition = static_cast<PerftPosition>(position);
+            if (mode == PERFT_CLASSIC) {
+                Field root;
+                total += runPosition(options, perftMode, perftPosition, root, ok);
+            } else if (mode == PERFT_BUCKET) {
+                BucketField root;
+                total += runPosition(options, perftMode, perftPosition, root, ok);
+            } else {
+                PictureField root(mode == PERFT_SQUARE ? PICTURE_SQUARE : PICTURE_TRIANGLE);
+                total += runPosition(options, perftMode, perftPosition, root, ok);
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Всего узлов: " << total << ", " << seconds << " с, "
+              << total / std::max(seconds, 1e-9) / 1e6 << " Музл/с" << std::endl;
+    if (!ok) {
+        std::cout << "Есть расхождения" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file tetris_replay.cpp
+ * @brief Воспроизведение повторов партий и сверка итогов
+ *
+ * Читает файлы повторов (tetris_replay_<зерно>.ttr, см. Replay.h),
+ * печатает заголовок, воспроизводит партию в TetrisEngine без терминала
+ * и сравнивает счет, линии и количество фигур с записью конца повтора.
+ * Расхождение означает, что правила движка изменились с момента записи,
+ * и программа завершается с кодом 1 - повторы годятся как регрессионные
+ * тесты и для проверки результатов турниров.
+ *
+ * Пример:
+ * @code{.sh}
+ * ./tetris_replay tetris_replay_42.ttr
+ * ./tetris_replay --events tetris_replay_42.ttr
+ * @endcode
+ */
+#include "Replay.h"
+#include "TetrisEngine.h"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const MODE_NAMES[MODE_COUNT] = {"classic", "bucket", "square", "triangle"};
+const char* const RANDOMIZER_NAMES[RANDOMIZER_COUNT] = {"random", "bag", "history"};
+const char* const ACTION_NAMES[ACTION_COUNT] = {"left", "right", "soft", "drop", "rotate", "gravity", "lock"};
+
+void printUsage(const char* program) {
+    std::cerr << "Использование: " << program << " [--events] ФАЙЛ...\n"
+              << "  --events          печатать записи повтора (тик и действие)\n";
+}
+
+/**
+ * @brief Воспроизводит один повтор
+ * @return true, если файл прочитан и итог совпал с записью конца
+ */
+bool checkReplay(const std::string& path, bool printEvents) {
+    ReplayHeader header;
+    std::vector<ReplayEvent> events;
+    ReplayTotals totals;
+    if (!readReplay(path, header, events, totals)) {
+        std::cout << path << ": не удалось прочитать повтор" << std::endl;
+        return false;
+    }
+
+    std::cout << path << ": " << MODE_NAMES[header.mode];
+    if (header.pictureType != 0) {
+        std::cout << " (картинка " << header.pictureType << ")";
+    }
+    std::cout << ", зерно " << header.seed << ", " << RANDOMIZER_NAMES[header.randomizer]
+              << ", поле " << header.boardWidth << "x" << header.boardHeight << "\n";
+    for (size_t i = 0; i < header.settings.size(); i++) {
+        std::cout << "  " << header.settings[i].first << " = " << header.settings[i].second << "\n";
+    }
+    if (printEvents) {
+        for (size_t i = 0; i < events.size(); i++) {
+            std::cout << "  " << events[i].tick << " " << ACTION_NAMES[events[i].action] << "\n";
+        }
+    }
+    if (header.boardWidth != BOARD_WIDTH || header.boardHeight != BOARD_HEIGHT) {
+        std::cout << "  записан на поле другого размера, эта сборка - " << BOARD_WIDTH << "x" << BOARD_HEIGHT
+                  << std::endl;
+        return false;
+    }
+
+    TetrisEngine engine;
+    playReplay(engine, header, events);
+    uint64_t ticks = events.empty() ? 0 : events.back().tick;
+    std::cout << "  записей " << events.size() << ", тиков " << ticks
+              << ": счет " << engine.getScore() << ", линии " << engine.getLinesCleared()
+              << ", фигуры " << engine.getPiecesLocked()
+              << (engine.isGameOver() ? ", партия окончена" : "") << std::endl;
+    if (!totals.present) {
+        std::cout << "  нет записи конца партии: итог не сверяется" << std::endl;
+        return true;
+    }
+    if (totals.score != engine.getScore() || totals.lines != engine.getLinesCleared() ||
+        totals.pieces != engine.getPiecesLocked()) {
+        std::cout << "  РАСХОЖДЕНИЕ: записано счет " << totals.score << ", линии " << totals.lines
+                  << ", фигуры " << totals.pieces << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    bool printEvents = false;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--events") {
+            printEvents = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < paths.size(); i++) {
+        ok = checkReplay(paths[i], printEvents) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,320 @@
+/**
+ * @file tetris_sim.cpp
+ * @brief Пакетный симулятор: прогоняет много партий TetrisEngine без терминала
+ *
+ * Партии с зернами seed, seed + 1, ... распределяются по ядрам через
+ * ThreadPool. Каждая партия детерминирована своим зерном, поэтому итоговая
+ * статистика не зависит от числа потоков. Исключение - --policy beam
+ * с --budget больше 0: поиск обрывается по времени, и его результат
+ * зависит от загрузки процессора, в том числе от числа потоков.
+ *
+ * Пример:
+ * @code{.sh}
+ * ./tetris_sim --games 1000000 --seed 1 --mode classic --policy script:adw
+ * @endcode
+ */
+#include "BeamSearchBot.h"
+#include "HeuristicBot.h"
+#include "TetrisEngine.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Способ выбора действий
+ */
+enum PolicyKind {
+    POLICY_RANDOM, /**< Случайное действие из LEFT/RIGHT/SOFT_DROP/HARD_DROP/ROTATE */
+    POLICY_DROP,   /**< Сразу бросать каждую фигуру */
+    POLICY_SCRIPT, /**< Повторять строку клавиш */
+    POLICY_BOT,    /**< Эвристический бот (HeuristicBot) */
+    POLICY_BEAM    /**< Лучевой поиск по очереди предпросмотра (BeamSearchBot) */
+};
+
+/**
+ * @brief Параметры запуска
+ */
+struct SimOptions {
+    uint64_t games = 1000;
+    uint64_t seed = 1;
+    GameMode mode = MODE_CLASSIC;
+    RandomizerKind randomizer = RANDOMIZER_RANDOM;
+    PolicyKind policy = POLICY_RANDOM;
+    std::string script;
+    unsigned threads = 0;
+    int maxPieces = 10000;
+    BeamSearchOptions search;
+    size_t grain = 64;
+};
+
+/**
+ * @brief Итоги набора партий
+ * @note Суммы складываются, поэтому порядок слияния не влияет на результат
+ */
+struct SimStats {
+    uint64_t games = 0;
+    uint64_t lines = 0;
+    uint64_t score = 0;
+    uint64_t pieces = 0;
+    uint64_t steps = 0;
+    uint64_t truncated = 0;
+    int maxLines = 0;
+    int64_t maxScore = 0;
+    int maxPieces = 0;
+    std::vector<uint64_t> levels;  /**< Количество партий по достигнутому уровню */
+
+    void merge(const SimStats& other) {
+        games += other.games;
+        lines += other.lines;
+        score += other.score;
+        pieces += other.pieces;
+        steps += other.steps;
+        truncated += other.truncated;
+        maxLines = std::max(maxLines, other.maxLines);
+        maxScore = std::max(maxScore, other.maxScore);
+        maxPieces = std::max(maxPieces, other.maxPieces);
+        if (levels.size() < other.levels.size()) {
+            levels.resize(other.levels.size(), 0);
+        }
+        for (size_t i = 0; i < other.levels.size(); i++) {
+            levels[i] += other.levels[i];
+        }
+    }
+};
+
+/**
+ * @brief Переводит клавишу сценария в действие
+ * @return true если клавиша известна
+ * @note Клавиши совпадают с управлением игры по умолчанию
+ */
+bool keyToAction(char key, EngineAction& action) {
+    switch (key) {
+        case 'a': action = ACTION_LEFT; return true;
+        case 'd': action = ACTION_RIGHT; return true;
+        case 's': action = ACTION_SOFT_DROP; return true;
+        case 'w': action = ACTION_HARD_DROP; return true;
+        case ' ':
+        case 'r': action = ACTION_ROTATE; return true;
+        case 'g': action = ACTION_GRAVITY; return true;
+        default: return false;
+    }
+}
+
+/**
+ * @brief Играет одну партию
+ * @note После каждого действия фигура опускается на строку (тик гравитации)
+ *       и фиксируется, если стоит на опоре, - задержка фиксации равна нулю.
+ *       Бот выполняет весь путь к выбранному положению без тиков гравитации
+ */
+void playGame(const SimOptions& options, const std::vector<EngineAction>& script,
+              uint64_t gameIndex, TetrisEngine& engine, HeuristicBot& bot, BeamSearchBot& beam,
+              SimStats& stats) {
+    uint64_t gameSeed = options.seed + gameIndex;
+    Xoshiro256 policyRng(gameSeed ^ 0x9e3779b97f4a7c15ULL);
+    engine.reset(gameSeed, options.mode, options.randomizer);
+
+    uint64_t steps = 0;
+    size_t scriptPos = 0;
+    while (!engine.isGameOver() && engine.getPiecesLocked() < options.maxPieces) {
+        if (options.policy == POLICY_BOT || options.policy == POLICY_BEAM) {
+            const std::vector<EngineAction>& path = (options.policy == POLICY_BOT)
+                ? bot.plan(*engine.getField(), engine.getFigure())
+                : beam.plan(engine);
+            if (path.empty()) {
+                engine.step(ACTION_HARD_DROP);
+                steps++;
+            }
+            for (size_t i = 0; i < path.size(); i++) {
+                engine.step(path[i]);
+            }
+            steps += path.size();
+            continue;
+        }
+        EngineAction action = ACTION_HARD_DROP;
+        if (options.policy == POLICY_RANDOM) {
+            action = static_cast<EngineAction>(policyRng.nextBelow(ACTION_ROTATE + 1));
+        } else if (options.policy == POLICY_SCRIPT) {
+            action = script[scriptPos];
+            scriptPos = (scriptPos + 1) % script.size();
+        }
+        StepResult result = engine.step(action);
+        steps++;
+        if (!result.locked && !result.gameOver) {
+            engine.step(ACTION_GRAVITY);
+            if (engine.isGrounded()) {
+                engine.step(ACTION_LOCK);
+            }
+        }
+    }
+
+    int level = engine.getLevel();
+    stats.games++;
+    stats.lines += engine.getLinesCleared();
+    stats.score += engine.getScore();
+    stats.pieces += engine.getPiecesLocked();
+    stats.steps += steps;
+    stats.truncated += engine.isGameOver() ? 0 : 1;
+    stats.maxLines = std::max(stats.maxLines, engine.getLinesCleared());
+    stats.maxScore = std::max(stats.maxScore, engine.getScore());
+    stats.maxPieces = std::max(stats.maxPieces, engine.getPiecesLocked());
+    if (stats.levels.size() <= static_cast<size_t>(level)) {
+        stats.levels.resize(level + 1, 0);
+    }
+    stats.levels[level]++;
+}
+
+bool parseMode(const std::string& name, GameMode& mode) {
+    if (name == "classic") mode = MODE_CLASSIC;
+    else if (name == "bucket") mode = MODE_BUCKET;
+    else if (name == "square") mode = MODE_PICTURE_SQUARE;
+    else if (name == "triangle") mode = MODE_PICTURE_TRIANGLE;
+    else return false;
+    return true;
+}
+
+bool parseRandomizer(const std::string& name, RandomizerKind& kind) {
+    if (name == "random") kind = RANDOMIZER_RANDOM;
+    else if (name == "bag") kind = RANDOMIZER_BAG7;
+    else if (name == "history") kind = RANDOMIZER_HISTORY;
+    else return false;
+    return true;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Использование: " << program << " [параметры]\n"
+              << "  --games N         количество партий (по умолчанию 1000)\n"
+              << "  --seed S          зерно первой партии; партия i играет с зерном S + i\n"
+              << "  --mode M          classic | bucket | square | triangle\n"
+              << "  --randomizer R    random | bag | history - выдача фигур\n"
+              << "  --policy P        random | drop | bot | beam | script:КЛАВИШИ (a d s w r g)\n"
+              << "  --depth K         beam: фигур в поиске (по умолчанию 3)\n"
+              << "  --beam B          beam: ширина луча (по умолчанию 16)\n"
+              << "  --budget US       beam: время на фигуру, мкс (0 - без ограничения;\n"
+              << "                    больше 0 - результаты зависят от скорости и числа потоков)\n"
+              << "  --search-threads N beam: потоков поиска в каждой партии (по умолчанию 1)\n"
+              << "  --threads T       количество потоков (0 - по числу ядер)\n"
+              << "  --max-pieces P    предел фигур в партии (по умолчанию 10000)\n";
+}
+
+bool parseOptions(int argc, char* argv[], SimOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--games") {
+            options.games = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--mode") {
+            if (!parseMode(value, options.mode)) return false;
+        } else if (arg == "--randomizer") {
+            if (!parseRandomizer(value, options.randomizer)) return false;
+        } else if (arg == "--threads") {
+            options.threads = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (arg == "--depth") {
+            options.search.depth = std::atoi(value.c_str());
+        } else if (arg == "--beam") {
+            options.search.width = std::atoi(value.c_str());
+        } else if (arg == "--budget") {
+            options.search.budgetMicros = std::atoll(value.c_str());
+        } else if (arg == "--search-threads") {
+            options.search.threads = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (arg == "--max-pieces") {
+            options.maxPieces = std::atoi(value.c_str());
+        } else if (arg == "--policy") {
+            if (value == "random") {
+                options.policy = POLICY_RANDOM;
+            } else if (value == "drop") {
+                options.policy = POLICY_DROP;
+            } else if (value == "bot") {
+                options.policy = POLICY_BOT;
+            } else if (value == "beam") {
+                options.policy = POLICY_BEAM;
+            } else if (value.compare(0, 7, "script:") == 0 && value.size() > 7) {
+                options.policy = POLICY_SCRIPT;
+                options.script = value.substr(7);
+            } else {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    return options.maxPieces > 0;
+}
+
+void printStats(const SimStats& stats, double seconds, unsigned threads) {
+    double games = stats.games > 0 ? static_cast<double>(stats.games) : 1.0;
+    std::cout << "Партий: " << stats.games << " (потоков: " << threads << ", "
+              << "оборвано по пределу фигур: " << stats.truncated << ")\n"
+              << "Линии:  среднее " << stats.lines / games << ", максимум " << stats.maxLines << "\n"
+              << "Счет:   среднее " << stats.score / games << ", максимум " << stats.maxScore << "\n"
+              << "Фигуры: среднее " << stats.pieces / games << ", максимум " << stats.maxPieces << "\n"
+              << "Длина партии: " << stats.steps / games << " действий\n"
+              << "Время: " << seconds << " с, " << stats.games / std::max(seconds, 1e-9)
+              << " партий/с, " << stats.steps / std::max(seconds, 1e-9) << " действий/с\n"
+              << "Достигнутый уровень:";
+    for (size_t level = 1; level < stats.levels.size(); level++) {
+        if (stats.levels[level] > 0) {
+            std::cout << " " << level << ":" << stats.levels[level];
+        }
+    }
+    std::cout << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    SimOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<EngineAction> script;
+    for (size_t i = 0; i < options.script.size(); i++) {
+        EngineAction action;
+        if (!keyToAction(options.script[i], action)) {
+            std::cerr << "Неизвестная клавиша сценария: '" << options.script[i] << "'" << std::endl;
+            return 1;
+        }
+        script.push_back(action);
+    }
+
+    ThreadPool pool(options.threads);
+    SimStats total;
+    std::mutex totalMutex;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t first = 0; first < options.games; first += options.grain) {
+        uint64_t last = std::min<uint64_t>(options.games, first + options.grain);
+        pool.submit([&, first, last] {
+            TetrisEngine engine;
+            HeuristicBot bot;
+            BeamSearchBot beam(options.search);
+            SimStats local;
+            for (uint64_t game = first; game < last; game++) {
+                playGame(options, script, game, engine, bot, beam, local);
+            }
+            std::lock_guard<std::mutex> lock(totalMutex);
+            total.merge(local);
+        });
+    }
+    pool.wait();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printStats(total, seconds, pool.size());
+    return 0;
+}
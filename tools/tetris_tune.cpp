@@ -0,0 +1,517 @@
+/**
+ * @file tetris_tune.cpp
+ * @brief Подбор весов HeuristicBot методом перекрестной энтропии
+ *
+ * Каждое поколение - population векторов весов из нормального
+ * распределения. Каждый вектор играет одни и те же партии с зернами
+ * seed, seed + 1, ... настоящим TetrisEngine (очки за линии и дроп
+ * считает движок), оценка вектора - средний счет. Векторы распределяются
+ * по ядрам через ThreadPool. Среднее и разброс следующего поколения
+ * считаются по elite лучшим векторам, к дисперсии добавляется затухающий
+ * шум, чтобы распределение не схлопнулось раньше времени.
+ *
+ * После каждого поколения состояние записывается в файл контрольной точки;
+ * --resume продолжает с него. Поколение g выбирается генератором с зерном,
+ * зависящим только от seed и g, поэтому прерванный и продолженный прогон
+ * дает те же веса, что и непрерывный.
+ *
+ * Пример:
+ * @code{.sh}
+ * ./tetris_tune --population 200 --elite 20 --games 16 --generations 30 --checkpoint tune.txt
+ * ./tetris_tune --resume tune.txt --generations 60
+ * @endcode
+ */
+#include "HeuristicBot.h"
+#include "TetrisEngine.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int WEIGHT_COUNT = 7;                 /**< Количество весов BotWeights */
+constexpr int CHECKPOINT_VERSION = 2;           /**< Версия формата контрольной точки */
+const char* const WEIGHT_NAMES[WEIGHT_COUNT] = {
+    "aggregateHeight", "holes", "bumpiness", "linesCleared", "wells",
+    "rowTransitions", "columnTransitions"
+};
+
+/**
+ * @brief Вектор весов в порядке WEIGHT_NAMES
+ */
+struct WeightVector {
+    double values[WEIGHT_COUNT];
+
+    static WeightVector fromWeights(const BotWeights& weights) {
+        WeightVector vector;
+        vector.values[0] = weights.aggregateHeight;
+        vector.values[1] = weights.holes;
+        vector.values[2] = weights.bumpiness;
+        vector.values[3] = weights.linesCleared;
+        vector.values[4] = weights.wells;
+        vector.values[5] = weights.rowTransitions;
+        vector.values[6] = weights.columnTransitions;
+        return vector;
+    }
+
+    BotWeights toWeights() const {
+        BotWeights weights;
+        weights.aggregateHeight = static_cast<float>(values[0]);
+        weights.holes = static_cast<float>(values[1]);
+        weights.bumpiness = static_cast<float>(values[2]);
+        weights.linesCleared = static_cast<float>(values[3]);
+        weights.wells = static_cast<float>(values[4]);
+        weights.rowTransitions = static_cast<float>(values[5]);
+        weights.columnTransitions = static_cast<float>(values[6]);
+        return weights;
+    }
+};
+
+/**
+ * @brief Параметры прогона
+ * @note Все поля, кроме generations, threads и checkpoint, влияют на
+ *       результат и сохраняются в контрольной точке
+ */
+struct TuneOptions {
+    int population = 200;
+    int elite = 20;
+    int generations = 30;
+    uint64_t games = 16;
+    uint64_t seed = 1;
+    GameMode mode = MODE_CLASSIC;
+    RandomizerKind randomizer = RANDOMIZER_RANDOM;
+    int maxPieces = 1000;
+    double sigma = 0.5;
+    double noise = 0.05;
+    unsigned threads = 0;
+    std::string checkpoint = "tetris_tune.txt";
+    std::string resume;
+};
+
+/**
+ * @brief Состояние прогона между поколениями
+ */
+struct TuneState {
+    int generation = 0;                  /**< Следующее поколение */
+    WeightVector mean;                   /**< Среднее распределения */
+    WeightVector deviation;              /**< Стандартное отклонение по каждому весу */
+    WeightVector best;                   /**< Лучший вектор за весь прогон */
+    double bestFitness = -std::numeric_limits<double>::infinity();
+    std::vector<WeightVector> population;  /**< Последнее поколение */
+    std::vector<double> fitness;           /**< Оценки последнего поколения */
+};
+
+/**
+ * @brief Итог партий одного вектора
+ */
+struct CandidateResult {
+    double score = 0.0;  /**< Средний счет (оценка) */
+    double lines = 0.0;  /**< Среднее число линий */
+};
+
+/**
+ * @brief Возвращает нормальное число (Бокс - Мюллер)
+ */
+double nextGaussian(Xoshiro256& rng) {
+    double u1 = ((rng.next() >> 11) + 1) * (1.0 / 9007199254740993.0);
+    double u2 = (rng.next() >> 11) * (1.0 / 9007199254740992.0);
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+}
+
+/**
+ * @brief Выбирает векторы поколения
+ * @note Зерно зависит только от seed и номера поколения
+ */
+void samplePopulation(const TuneOptions& options, TuneState& state) {
+    Xoshiro256 rng(options.seed * 0x9e3779b97f4a7c15ULL + static_cast<uint64_t>(state.generation));
+    state.population.assign(options.population, state.mean);
+    /** Вектор 0 - само среднее: оценка текущего распределения без шума выборки */
+    for (int i = 1; i < options.population; i++) {
+        for (int k = 0; k < WEIGHT_COUNT; k++) {
+            state.population[i].values[k] += state.deviation.values[k] * nextGaussian(rng);
+        }
+    }
+}
+
+/**
+ * @brief Играет партии набора зерен одним вектором весов
+ * @note Бот выполняет весь путь к выбранному положению без тиков
+ *       гравитации, как tetris_sim --policy bot
+ */
+CandidateResult playCandidate(const TuneOptions& options, const WeightVector& weights) {
+    TetrisEngine engine;
+    HeuristicBot bot(weights.toWeights());
+    CandidateResult result;
+    for (uint64_t game = 0; game < options.games; game++) {
+        engine.reset(options.seed + game, options.mode, options.randomizer);
+        while (!engine.isGameOver() && engine.getPiecesLocked() < options.maxPieces) {
+            const std::vector<EngineAction>& path = bot.plan(*engine.getField(), engine.getFigure());
+            if (path.empty()) {
+                engine.step(ACTION_HARD_DROP);
+            }
+            for (size_t i = 0; i < path.size(); i++) {
+                engine.step(path[i]);
+            }
+        }
+        result.score += engine.getScore();
+        result.lines += engine.getLinesCleared();
+    }
+    result.score /= static_cast<double>(options.games);
+    result.lines /= static_cast<double>(options.games);
+    return result;
+}
+
+/**
+ * @brief Пересчитывает распределение по лучшим векторам поколения
+ * @param order Номера векторов по убыванию оценки
+ */
+void updateDistribution(const TuneOptions& options, const std::vector<int>& order, TuneState& state) {
+    int elite = std::min(options.elite, options.population);
+    double extra = options.noise / (state.generation + 1);
+    for (int k = 0; k < WEIGHT_COUNT; k++) {
+        double sum = 0.0;
+        for (int i = 0; i < elite; i++) {
+            sum += state.population[order[i]].values[k];
+        }
+        double mean = sum / elite;
+        double variance = 0.0;
+        for (int i = 0; i < elite; i++) {
+            double delta = state.population[order[i]].values[k] - mean;
+            variance += delta * delta;
+        }
+        state.mean.values[k] = mean;
+        state.deviation.values[k] = std::sqrt(variance / elite + extra);
+    }
+}
+
+const char* modeName(GameMode mode) {
+    switch (mode) {
+        case MODE_BUCKET: return "bucket";
+        case MODE_PICTURE_SQUARE: return "square";
+        case MODE_PICTURE_TRIANGLE: return "triangle";
+        default: return "classic";
+    }
+}
+
+bool parseMode(const std::string& name, GameMode& mode) {
+    if (name == "classic") mode = MODE_CLASSIC;
+    else if (name == "bucket") mode = MODE_BUCKET;
+    else if (name == "square") mode = MODE_PICTURE_SQUARE;
+    else if (name == "triangle") mode = MODE_PICTURE_TRIANGLE;
+    else return false;
+    return true;
+}
+
+const char* randomizerName(RandomizerKind kind) {
+    switch (kind) {
+        case RANDOMIZER_BAG7: return "bag";
+        case RANDOMIZER_HISTORY: return "history";
+        default: return "random";
+    }
+}
+
+bool parseRandomizer(const std::string& name, RandomizerKind& kind) {
+    if (name == "random") kind = RANDOMIZER_RANDOM;
+    else if (name == "bag") kind = RANDOMIZER_BAG7;
+    else if (name == "history") kind = RANDOMIZER_HISTORY;
+    else return false;
+    return true;
+}
+
+void writeVector(std::ostream& out, const WeightVector& vector) {
+    for (int k = 0; k < WEIGHT_COUNT; k++) {
+        out << " " << vector.values[k];
+    }
+}
+
+bool readVector(std::istream& in, WeightVector& vector) {
+    for (int k = 0; k < WEIGHT_COUNT; k++) {
+        if (!(in >> vector.values[k])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Записывает контрольную точку
+ * @note Файл пишется рядом под именем path.tmp и переименовывается,
+ *       поэтому обрыв во время записи не портит предыдущую точку
+ */
+bool saveCheckpoint(const std::string& path, const TuneOptions& options, const TuneState& state) {
+    std::string temporary = path + ".tmp";
+    std::ofstream file(temporary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    file << "tetris_tune " << CHECKPOINT_VERSION << "\n"
+         << "seed " << options.seed << "\n"
+         << "games " << options.games << "\n"
+         << "mode " << modeName(options.mode) << "\n"
+         << "randomizer " << randomizerName(options.randomizer) << "\n"
+         << "max-pieces " << options.maxPieces << "\n"
+         << "population " << options.population << "\n"
+         << "elite " << options.elite << "\n"
+         << "noise " << options.noise << "\n"
+         << "generation " << state.generation << "\n";
+    file << "mean";
+    writeVector(file, state.mean);
+    file << "\ndeviation";
+    writeVector(file, state.deviation);
+    file << "\nbest " << state.bestFitness;
+    writeVector(file, state.best);
+    file << "\n# оценка и веса последнего поколения:";
+    for (int k = 0; k < WEIGHT_COUNT; k++) {
+        file << " " << WEIGHT_NAMES[k];
+    }
+    file << "\n";
+    for (size_t i = 0; i < state.population.size() && i < state.fitness.size(); i++) {
+        file << "candidate " << state.fitness[i];
+        writeVector(file, state.population[i]);
+        file << "\n";
+    }
+    file.close();
+    if (!file) {
+        return false;
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * @brief Читает контрольную точку
+ * @note Параметры, влияющие на результат, берутся из файла
+ */
+bool loadCheckpoint(const std::string& path, TuneOptions& options, TuneState& state) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string line;
+    bool versionOk = false;
+    bool hasMean = false;
+    bool hasDeviation = false;
+    state.population.clear();
+    state.fitness.clear();
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream in(line);
+        std::string key;
+        in >> key;
+        bool ok = true;
+        if (key == "tetris_tune") {
+            int version = 0;
+            ok = static_cast<bool>(in >> version);
+            versionOk = (version == CHECKPOINT_VERSION);
+        } else if (key == "seed") {
+            ok = static_cast<bool>(in >> options.seed);
+        } else if (key == "games") {
+            ok = static_cast<bool>(in >> options.games);
+        } else if (key == "mode") {
+            std::string name;
+            ok = (in >> name) && parseMode(name, options.mode);
+        } else if (key == "randomizer") {
+            std::string name;
+            ok = (in >> name) && parseRandomizer(name, options.randomizer);
+        } else if (key == "max-pieces") {
+            ok = static_cast<bool>(in >> options.maxPieces);
+        } else if (key == "population") {
+            ok = static_cast<bool>(in >> options.population);
+        } else if (key == "elite") {
+            ok = static_cast<bool>(in >> options.elite);
+        } else if (key == "noise") {
+            ok = static_cast<bool>(in >> options.noise);
+        } else if (key == "generation") {
+            ok = static_cast<bool>(in >> state.generation);
+        } else if (key == "mean") {
+            ok = hasMean = readVector(in, state.mean);
+        } else if (key == "deviation") {
+            ok = hasDeviation = readVector(in, state.deviation);
+        } else if (key == "best") {
+            ok = (in >> state.bestFitness) && readVector(in, state.best);
+        } else if (key == "candidate") {
+            double fitness = 0.0;
+            WeightVector vector;
+            ok = (in >> fitness) && readVector(in, vector);
+            state.fitness.push_back(fitness);
+            state.population.push_back(vector);
+        }
+        if (!ok) {
+            std::cerr << "Ошибка в контрольной точке: " << line << std::endl;
+            return false;
+        }
+    }
+    return versionOk && hasMean && hasDeviation;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Использование: " << program << " [параметры]\n"
+              << "  --population N    векторов в поколении (по умолчанию 200)\n"
+              << "  --elite E         лучших векторов для нового распределения (по умолчанию 20)\n"
+              << "  --generations G   сколько поколений пройти всего (по умолчанию 30)\n"
+              << "  --games N         партий на вектор (по умолчанию 16)\n"
+              << "  --seed S          зерно первой партии и выбора векторов\n"
+              << "  --mode M          classic | bucket | square | triangle\n"
+              << "  --randomizer R    random | bag | history - выдача фигур\n"
+              << "  --max-pieces P    предел фигур в партии (по умолчанию 1000)\n"
+              << "  --sigma D         начальное отклонение весов (по умолчанию 0.5)\n"
+              << "  --noise V         добавка к дисперсии, делится на номер поколения (0.05)\n"
+              << "  --threads T       количество потоков (0 - по числу ядер)\n"
+              << "  --checkpoint F    файл контрольной точки (по умолчанию tetris_tune.txt)\n"
+              << "  --resume F        продолжить с контрольной точки F\n";
+}
+
+bool parseOptions(int argc, char* argv[], TuneOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--population") {
+            options.population = std::atoi(value.c_str());
+        } else if (arg == "--elite") {
+            options.elite = std::atoi(value.c_str());
+        } else if (arg == "--generations") {
+            options.generations = std::atoi(value.c_str());
+        } else if (arg == "--games") {
+            options.games = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--mode") {
+            if (!parseMode(value, options.mode)) return false;
+        } else if (arg == "--randomizer") {
+            if (!parseRandomizer(value, options.randomizer)) return false;
+        } else if (arg == "--max-pieces") {
+            options.maxPieces = std::atoi(value.c_str());
+        } else if (arg == "--sigma") {
+            options.sigma = std::atof(value.c_str());
+        } else if (arg == "--noise") {
+            options.noise = std::atof(value.c_str());
+        } else if (arg == "--threads") {
+            options.threads = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (arg == "--checkpoint") {
+            options.checkpoint = value;
+        } else if (arg == "--resume") {
+            options.resume = value;
+        } else {
+            return false;
+        }
+    }
+    return options.population > 0 && options.elite > 0 && options.games > 0 &&
+           options.maxPieces > 0 && options.sigma >= 0.0 && options.noise >= 0.0;
+}
+
+/**
+ * @brief Записывает вес литералом float для вставки в BotWeights (0 - "0.0f", а не "0f")
+ */
+std::string floatLiteral(double value) {
+    std::ostringstream out;
+    out << std::setprecision(6) << static_cast<float>(value);
+    std::string text = out.str();
+    if (text.find_first_of(".e") == std::string::npos) {
+        text += ".0";
+    }
+    return text + "f";
+}
+
+void printWeights(const WeightVector& vector) {
+    for (int k = 0; k < WEIGHT_COUNT; k++) {
+        std::cout << "    float " << WEIGHT_NAMES[k] << " = " << floatLiteral(vector.values[k]) << ";\n";
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    TuneOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    TuneState state;
+    if (!options.resume.empty()) {
+        if (!loadCheckpoint(options.resume, options, state)) {
+            std::cerr << "Не удалось прочитать контрольную точку " << options.resume << std::endl;
+            return 1;
+        }
+        std::cout << "Продолжение с поколения " << state.generation << " (" << options.resume << ")\n";
+    } else {
+        state.mean = WeightVector::fromWeights(BotWeights());
+        for (int k = 0; k < WEIGHT_COUNT; k++) {
+            state.deviation.values[k] = options.sigma;
+        }
+        state.best = state.mean;
+    }
+
+    ThreadPool pool(options.threads);
+    std::cout << "Векторов: " << options.population << ", лучших: " << options.elite
+              << ", партий на вектор: " << options.games << ", потоков: " << pool.size() << std::endl;
+
+    std::vector<CandidateResult> results;
+    std::vector<int> order;
+    while (state.generation < options.generations) {
+        auto start = std::chrono::steady_clock::now();
+        samplePopulation(options, state);
+        results.assign(options.population, CandidateResult());
+        for (int i = 0; i < options.population; i++) {
+            pool.submit([&, i] {
+                results[i] = playCandidate(options, state.population[i]);
+            });
+        }
+        pool.wait();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        state.fitness.resize(options.population);
+        order.resize(options.population);
+        for (int i = 0; i < options.population; i++) {
+            state.fitness[i] = results[i].score;
+            order[i] = i;
+        }
+        /** Равные оценки упорядочены по номеру - отбор не зависит от сортировки */
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            if (state.fitness[a] != state.fitness[b]) return state.fitness[a] > state.fitness[b];
+            return a < b;
+        });
+        int top = order.front();
+        if (state.fitness[top] > state.bestFitness) {
+            state.bestFitness = state.fitness[top];
+            state.best = state.population[top];
+        }
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "Поколение " << state.generation
+                  << ": лучший " << state.fitness[top] << " (линии " << results[top].lines << ")"
+                  << ", среднее распределения " << state.fitness[0] << " (линии " << results[0].lines << ")"
+                  << ", " << std::setprecision(2) << seconds << " с" << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+
+        updateDistribution(options, order, state);
+        state.generation++;
+        if (!saveCheckpoint(options.checkpoint, options, state)) {
+            std::cerr << "Не удалось записать контрольную точку " << options.checkpoint << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Лучший средний счет: " << std::fixed << std::setprecision(1) << state.bestFitness << "\n";
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << "Веса (BotWeights):\n";
+    printWeights(state.best);
+    std::cout << "Среднее распределения:\n";
+    printWeights(state.mean);
+    return 0;
+}